@@ -0,0 +1,271 @@
+/**
+ * @file agi_bench.cpp
+ * @brief Microbenchmark suite (make bench)
+ * @author AGI Team
+ * @version 1.0.0
+ * @date 2025-12-28
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "utils.hpp"
+#include "config.hpp"
+#include "jail.hpp"
+#include "logger.hpp"
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every benchmark reports allocs/op alongside ns/op
+// ---------------------------------------------------------------------------
+
+static std::atomic<uint64_t> g_alloc_count{0};
+
+// noinline keeps gcc from pairing these with its builtin new/delete
+// knowledge and warning about the malloc/free implementation
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void* operator new[](size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace agi {
+
+// ---------------------------------------------------------------------------
+// Harness: warmup iterations, then timed repetitions
+// ---------------------------------------------------------------------------
+
+static void runBench(const std::string& name, size_t iterations,
+                     const std::function<void()>& op) {
+    size_t warmup = iterations / 10;
+    if (warmup == 0) warmup = 1;
+    for (size_t i = 0; i < warmup; ++i) {
+        op();
+    }
+
+    uint64_t allocs_before = g_alloc_count.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        op();
+    }
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocs = g_alloc_count.load(std::memory_order_relaxed) -
+                      allocs_before;
+
+    uint64_t total_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count());
+
+    printf("%-32s %10zu %14.1f %12.1f\n", name.c_str(), iterations,
+           static_cast<double>(total_ns) / iterations,
+           static_cast<double>(allocs) / iterations);
+    fflush(stdout);
+}
+
+// ---------------------------------------------------------------------------
+// JSON parsing on generated configs
+// ---------------------------------------------------------------------------
+
+static std::string generateConfig(size_t env_count) {
+    std::string json =
+        "{\n  \"global\": {\n    \"base_path\": \"/var/lib/agi\",\n"
+        "    \"log_path\": \"/var/log/agi/agi.log\",\n"
+        "    \"log_level\": \"info\",\n    \"daemonize\": false\n  },\n"
+        "  \"environments\": [\n";
+
+    for (size_t i = 0; i < env_count; ++i) {
+        json += "    {\n"
+                "      \"name\": \"env-" + std::to_string(i) + "\",\n"
+                "      \"description\": \"benchmark environment\",\n"
+                "      \"os_template\": \"debian-12\",\n"
+                "      \"architecture\": \"x86_64\",\n"
+                "      \"enabled\": true,\n"
+                "      \"ssh\": {\n"
+                "        \"port\": " + std::to_string(22000 + i) + ",\n"
+                "        \"listen_address\": \"127.0.0.1\"\n"
+                "      },\n"
+                "      \"users\": [{\"name\": \"root\"}]\n"
+                "    }";
+        json += (i + 1 < env_count) ? ",\n" : "\n";
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+static void benchJsonParse() {
+    for (size_t envs : {10, 100, 1000}) {
+        std::string doc = generateConfig(envs);
+        size_t iterations = envs >= 1000 ? 200 : (envs >= 100 ? 2000 : 20000);
+        runBench("json_parse_" + std::to_string(envs) + "_envs", iterations,
+                 [&doc]() {
+                     JsonParser parser{std::string_view(doc)};
+                     JsonValue value = parser.parse();
+                     (void)value;
+                 });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Jail create/destroy against a scratch directory (no root-only mounts:
+// mounting only happens in start(), which is not exercised here)
+// ---------------------------------------------------------------------------
+
+static void benchJail() {
+    std::string base = "/tmp/agi-bench-" + std::to_string(getpid());
+    std::filesystem::create_directories(base);
+
+    EnvironmentConfig config;
+    config.name = "bench";
+    config.os_template = "none";
+    config.ssh.port = 22999;
+    config.ssh.listen_address = "127.0.0.1";
+
+    size_t next = 0;
+    runBench("jail_create_destroy", 5, [&]() {
+        std::string path = base + "/jail-" + std::to_string(next++);
+        JailManager jail(config, path);
+        jail.create();
+        jail.destroy();
+    });
+
+    FileUtils::removeRecursiveParallel(base);
+}
+
+// ---------------------------------------------------------------------------
+// Logger throughput per sink
+// ---------------------------------------------------------------------------
+
+static void benchLoggerSink(const std::string& name,
+                            std::unique_ptr<LogSink> sink,
+                            size_t iterations) {
+    Logger logger;
+    logger.addSink(std::move(sink));
+    runBench(name, iterations, [&logger]() {
+        logger.info("bench", "benchmark log message with typical length");
+    });
+    logger.flush();
+}
+
+static void benchLogger() {
+    std::string base = "/tmp/agi-bench-log-" + std::to_string(getpid());
+    std::filesystem::create_directories(base);
+
+    benchLoggerSink("logger_file_sink",
+                    std::make_unique<FileLogSink>(base + "/text.log"),
+                    100000);
+    benchLoggerSink("logger_binary_sink",
+                    std::make_unique<BinaryLogSink>(base + "/bin"),
+                    100000);
+
+    // Console sink writes to stdout; point it at /dev/null for the
+    // duration so the numbers reflect the sink, not the terminal
+    int saved = dup(STDOUT_FILENO);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (saved >= 0 && devnull >= 0) {
+        fflush(stdout);
+        std::cout.flush();
+        dup2(devnull, STDOUT_FILENO);
+        Logger logger;
+        logger.addSink(std::make_unique<ConsoleLogSink>(false, true));
+
+        uint64_t allocs_before = g_alloc_count.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        constexpr size_t ITERS = 20000;
+        for (size_t i = 0; i < ITERS; ++i) {
+            logger.info("bench", "benchmark log message with typical length");
+        }
+        auto end = std::chrono::steady_clock::now();
+        uint64_t allocs = g_alloc_count.load(std::memory_order_relaxed) -
+                          allocs_before;
+
+        std::cout.flush();
+        dup2(saved, STDOUT_FILENO);
+
+        uint64_t total_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+        printf("%-32s %10zu %14.1f %12.1f\n", "logger_console_sink", ITERS,
+               static_cast<double>(total_ns) / ITERS,
+               static_cast<double>(allocs) / ITERS);
+    }
+    if (saved >= 0) close(saved);
+    if (devnull >= 0) close(devnull);
+
+    FileUtils::removeRecursiveParallel(base);
+}
+
+// ---------------------------------------------------------------------------
+// StringUtils / PathUtils hot functions
+// ---------------------------------------------------------------------------
+
+static void benchStringUtils() {
+    const std::string path = "/var/lib/agi/jails/dev-env/usr/share/agi/init.sh";
+    const std::string padded = "   some value with surrounding space   ";
+    const std::string csv = "proc,sysfs,devpts,tmpfs,overlay,ext4,xfs,btrfs";
+
+    runBench("stringutils_split", 200000, [&csv]() {
+        auto parts = StringUtils::split(csv, ',');
+        (void)parts;
+    });
+    runBench("stringutils_trim", 500000, [&padded]() {
+        auto trimmed = StringUtils::trim(padded);
+        (void)trimmed;
+    });
+    runBench("stringutils_replace", 200000, [&path]() {
+        auto replaced = StringUtils::replace(path, "agi", "AGI");
+        (void)replaced;
+    });
+    runBench("pathutils_normalize", 200000, [&path]() {
+        auto normalized = PathUtils::normalize(path);
+        (void)normalized;
+    });
+    runBench("pathutils_parent", 500000, [&path]() {
+        auto parent = PathUtils::parent(path);
+        (void)parent;
+    });
+}
+
+} // namespace agi
+
+int main() {
+    printf("AGI microbenchmarks\n");
+    printf("%-32s %10s %14s %12s\n", "BENCHMARK", "ITERS", "NS/OP",
+           "ALLOCS/OP");
+
+    agi::benchJsonParse();
+    agi::benchStringUtils();
+    agi::benchLogger();
+    agi::benchJail();
+
+    return 0;
+}
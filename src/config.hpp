@@ -12,11 +12,18 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <variant>
 #include <memory>
 #include <stdexcept>
 #include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
 #include "utils.hpp"
+#include "stats.hpp"
+#include "ports.hpp"
 
 namespace agi {
 
@@ -46,8 +53,11 @@ public:
     JsonValue(double val) : value_(val) {}
     JsonValue(const char* val) : value_(std::string(val)) {}
     JsonValue(const std::string& val) : value_(val) {}
+    JsonValue(std::string&& val) : value_(std::move(val)) {}
     JsonValue(const std::vector<JsonValue>& val) : value_(val) {}
+    JsonValue(std::vector<JsonValue>&& val) : value_(std::move(val)) {}
     JsonValue(const std::map<std::string, JsonValue>& val) : value_(val) {}
+    JsonValue(std::map<std::string, JsonValue>&& val) : value_(std::move(val)) {}
     
     // Type checking methods
     bool isNull() const { return std::holds_alternative<std::nullptr_t>(value_); }
@@ -107,44 +117,121 @@ public:
     // Serialization
     std::string serialize(int indent = 0) const {
         std::string result;
-        serializeTo(result, indent, 0);
+        result.reserve(estimateSize(indent));
+        std::string indent_cache;
+        writeValue(result, indent, 0, indent_cache);
         return result;
     }
-    
+
+    /**
+     * @brief Serialize directly to a stream
+     *
+     * The document is never materialized as one string; large configs
+     * stream straight to the target file.
+     */
+    void serialize(std::ostream& os, int indent = 0) const {
+        std::string indent_cache;
+        writeValue(os, indent, 0, indent_cache);
+    }
+
+    /**
+     * @brief Estimate the serialized size for output pre-reservation
+     */
+    size_t estimateSize(int indent = 0) const {
+        if (isNull() || isBool()) {
+            return 5;
+        }
+        if (isNumber()) {
+            return 24;
+        }
+        if (isString()) {
+            return asString().size() + 8;
+        }
+
+        size_t total = 4;
+        size_t per_entry = static_cast<size_t>(indent) + 4;
+        if (isArray()) {
+            for (const auto& item : asArray()) {
+                total += item.estimateSize(indent) + per_entry;
+            }
+        } else {
+            for (const auto& [key, val] : asObject()) {
+                total += key.size() + val.estimateSize(indent) + per_entry + 4;
+            }
+        }
+        return total;
+    }
+
 private:
-    void serializeTo(std::string& result, int indent, int currentIndent) const {
-        std::string spaces(currentIndent * indent, ' ');
-        
+    // Sink adapters: the writer below works against either a string
+    // (with pre-reserved capacity) or an ostream
+    static void put(std::string& out, const char* data, size_t len) {
+        out.append(data, len);
+    }
+    static void put(std::ostream& out, const char* data, size_t len) {
+        out.write(data, static_cast<std::streamsize>(len));
+    }
+    template<typename Out>
+    static void put(Out& out, const std::string& str) {
+        put(out, str.data(), str.size());
+    }
+    template<typename Out>
+    static void put(Out& out, const char* str) {
+        put(out, str, std::strlen(str));
+    }
+
+    /**
+     * @brief Append depth*indent spaces using a shared, grown-once cache
+     */
+    template<typename Out>
+    static void putIndent(Out& out, int indent, int depth,
+                          std::string& indent_cache) {
+        size_t needed = static_cast<size_t>(indent) * depth;
+        if (indent_cache.size() < needed) {
+            indent_cache.assign(needed, ' ');
+        }
+        put(out, indent_cache.data(), needed);
+    }
+
+    template<typename Out>
+    void writeValue(Out& out, int indent, int depth,
+                    std::string& indent_cache) const {
         if (isNull()) {
-            result += "null";
+            put(out, "null");
         } else if (isBool()) {
-            result += asBool() ? "true" : "false";
+            put(out, asBool() ? "true" : "false");
         } else if (isNumber()) {
-            result += std::to_string(asNumber());
+            put(out, std::to_string(asNumber()));
         } else if (isString()) {
-            result += "\"" + StringUtils::jsonEscape(asString()) + "\"";
+            put(out, "\"");
+            put(out, StringUtils::jsonEscape(asString()));
+            put(out, "\"");
         } else if (isArray()) {
-            result += "[\n";
+            put(out, "[\n");
             const auto& arr = asArray();
             for (size_t i = 0; i < arr.size(); ++i) {
-                result += spaces + std::string(indent, ' ');
-                arr[i].serializeTo(result, indent, currentIndent + 1);
-                if (i < arr.size() - 1) result += ",";
-                result += "\n";
+                putIndent(out, indent, depth + 1, indent_cache);
+                arr[i].writeValue(out, indent, depth + 1, indent_cache);
+                if (i < arr.size() - 1) put(out, ",");
+                put(out, "\n");
             }
-            result += spaces + "]";
+            putIndent(out, indent, depth, indent_cache);
+            put(out, "]");
         } else if (isObject()) {
-            result += "{\n";
+            put(out, "{\n");
             const auto& obj = asObject();
             size_t count = 0;
             for (const auto& [key, val] : obj) {
-                result += spaces + std::string(indent, ' ');
-                result += "\"" + StringUtils::jsonEscape(key) + "\": ";
-                val.serializeTo(result, indent, currentIndent + 1);
-                if (++count < obj.size()) result += ",";
-                result += "\n";
+                putIndent(out, indent, depth + 1, indent_cache);
+                put(out, "\"");
+                put(out, StringUtils::jsonEscape(key));
+                put(out, "\": ");
+                val.writeValue(out, indent, depth + 1, indent_cache);
+                if (++count < obj.size()) put(out, ",");
+                put(out, "\n");
             }
-            result += spaces + "}";
+            putIndent(out, indent, depth, indent_cache);
+            put(out, "}");
         }
     }
 };
@@ -154,11 +241,21 @@ private:
  */
 class JsonParser {
 private:
-    std::string json_;
+    std::string owned_;
+    std::string_view json_;
     size_t pos_;
-    
+
 public:
-    JsonParser(const std::string& json) : json_(json), pos_(0) {}
+    JsonParser(const std::string& json)
+        : owned_(json), json_(owned_), pos_(0) {}
+
+    /**
+     * @brief Parse over an external buffer (e.g. an mmap'd file)
+     *
+     * The caller keeps the buffer alive for the parser's lifetime; no
+     * copy of the document is made.
+     */
+    explicit JsonParser(std::string_view json) : json_(json), pos_(0) {}
     
     JsonValue parse() {
         skipWhitespace();
@@ -237,37 +334,57 @@ private:
     }
     
     JsonValue parseString() {
+        return JsonValue(parseStringRaw());
+    }
+
+    /**
+     * @brief Single-pass string scan with bulk span copies
+     *
+     * Unescaped runs are appended in one shot instead of character by
+     * character; the common no-escape case is a single append.
+     */
+    std::string parseStringRaw() {
         expect("\"");
         std::string result;
-        
-        while (peek() != '"' && peek() != '\0') {
-            char c = consume();
-            
-            if (c == '\\') {
-                char next = consume();
-                switch (next) {
-                    case '"':  result += '"'; break;
-                    case '\\': result += '\\'; break;
-                    case '/':  result += '/'; break;
-                    case 'b':  result += '\b'; break;
-                    case 'f':  result += '\f'; break;
-                    case 'n':  result += '\n'; break;
-                    case 'r':  result += '\r'; break;
-                    case 't':  result += '\t'; break;
-                    case 'u':
-                        result += parseUnicodeEscape();
-                        break;
-                    default:
-                        result += next;
-                        break;
-                }
-            } else {
-                result += c;
+        size_t span_start = pos_;
+
+        while (pos_ < json_.size()) {
+            char c = json_[pos_];
+
+            if (c == '"') {
+                result.append(json_, span_start, pos_ - span_start);
+                ++pos_;
+                return result;
             }
+
+            if (c != '\\') {
+                ++pos_;
+                continue;
+            }
+
+            result.append(json_, span_start, pos_ - span_start);
+            ++pos_;  // consume the backslash
+            char next = consume();
+            switch (next) {
+                case '"':  result += '"'; break;
+                case '\\': result += '\\'; break;
+                case '/':  result += '/'; break;
+                case 'b':  result += '\b'; break;
+                case 'f':  result += '\f'; break;
+                case 'n':  result += '\n'; break;
+                case 'r':  result += '\r'; break;
+                case 't':  result += '\t'; break;
+                case 'u':
+                    result += parseUnicodeEscape();
+                    break;
+                default:
+                    result += next;
+                    break;
+            }
+            span_start = pos_;
         }
-        
-        expect("\"");
-        return result;
+
+        throw ConfigError("Unterminated string");
     }
     
     char parseUnicodeEscape() {
@@ -281,27 +398,22 @@ private:
     }
     
     JsonValue parseNumber() {
+        // Scan the number span in place, then convert through a small
+        // stack buffer (the view may not be NUL-terminated)
         size_t start = pos_;
-        bool hasDecimal = false;
-        
-        if (consume() == '-') {}
-        else { --pos_; }
-        
-        // Integer part
+
+        if (peek() == '-') {
+            consume();
+        }
         while (std::isdigit(peek())) {
             consume();
         }
-        
-        // Fractional part
         if (peek() == '.') {
-            hasDecimal = true;
             consume();
             while (std::isdigit(peek())) {
                 consume();
             }
         }
-        
-        // Exponent part
         if (peek() == 'e' || peek() == 'E') {
             consume();
             if (peek() == '+' || peek() == '-') {
@@ -311,8 +423,21 @@ private:
                 consume();
             }
         }
-        
-        double value = std::stod(json_.substr(start, pos_ - start));
+
+        size_t len = pos_ - start;
+        if (len == 0 || len >= 64) {
+            throw ConfigError("Invalid number");
+        }
+
+        char buffer[64];
+        std::memcpy(buffer, json_.data() + start, len);
+        buffer[len] = '\0';
+
+        char* end = nullptr;
+        double value = std::strtod(buffer, &end);
+        if (end != buffer + len) {
+            throw ConfigError("Invalid number");
+        }
         return value;
     }
     
@@ -323,13 +448,13 @@ private:
         skipWhitespace();
         if (peek() == ']') {
             consume();
-            return result;
+            return JsonValue(std::move(result));
         }
         
         while (true) {
             result.push_back(parseValue());
             skipWhitespace();
-            
+
             if (peek() == ',') {
                 consume();
                 continue;
@@ -340,8 +465,8 @@ private:
                 throw ConfigError("Expected comma or closing bracket in array");
             }
         }
-        
-        return result;
+
+        return JsonValue(std::move(result));
     }
     
     JsonValue parseObject() {
@@ -351,25 +476,25 @@ private:
         skipWhitespace();
         if (peek() == '}') {
             consume();
-            return result;
+            return JsonValue(std::move(result));
         }
-        
+
         while (true) {
             skipWhitespace();
-            
+
             if (peek() != '"') {
                 throw ConfigError("Object keys must be strings");
             }
-            
-            std::string key = parseString().asString();
+
+            std::string key = parseStringRaw();
             skipWhitespace();
-            
+
             expect(":");
             skipWhitespace();
-            
-            result[key] = parseValue();
+
+            result.insert_or_assign(std::move(key), parseValue());
             skipWhitespace();
-            
+
             if (peek() == ',') {
                 consume();
                 continue;
@@ -380,8 +505,8 @@ private:
                 throw ConfigError("Expected comma or closing bracket in object");
             }
         }
-        
-        return result;
+
+        return JsonValue(std::move(result));
     }
     
     void expect(const std::string& str) {
@@ -488,10 +613,356 @@ struct GlobalConfig {
     std::string log_level = "INFO";
     bool daemonize = false;
     std::string pid_file = "/var/run/agi.pid";
-    
+
+    // Range the port registry allocates SSH ports from (inclusive)
+    int port_range_start = 2200;
+    int port_range_end = 2999;
+
+    // Seconds between metrics samples in daemon mode; 0 disables
+    int metrics_interval = 5;
+
     std::vector<EnvironmentConfig> environments;
 };
 
+/**
+ * @brief Binary compiled config cache
+ *
+ * A compact snapshot of the parsed GlobalConfig is written next to the
+ * JSON source and validated against the source's mtime and size. On a
+ * cache hit the snapshot is memory-mapped and decoded directly, which
+ * skips the recursive JSON parse and its JsonValue allocation tree
+ * entirely; any mismatch or decode error falls back to JSON parsing.
+ */
+class ConfigBinaryCache {
+private:
+    static constexpr uint32_t MAGIC = 0x43494741;  // "AGIC"
+    static constexpr uint32_t VERSION = 3;
+
+    /**
+     * @brief Bounds-checked reader over the mapped snapshot
+     */
+    class Reader {
+    private:
+        const char* data_;
+        size_t size_;
+        size_t pos_ = 0;
+
+    public:
+        Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+        uint32_t u32() {
+            uint32_t v;
+            raw(&v, sizeof(v));
+            return v;
+        }
+
+        int64_t i64() {
+            int64_t v;
+            raw(&v, sizeof(v));
+            return v;
+        }
+
+        bool boolean() {
+            char v;
+            raw(&v, sizeof(v));
+            return v != 0;
+        }
+
+        std::string str() {
+            uint32_t len = u32();
+            if (pos_ + len > size_) {
+                throw ConfigError("Config cache truncated");
+            }
+            std::string result(data_ + pos_, len);
+            pos_ += len;
+            return result;
+        }
+
+    private:
+        void raw(void* out, size_t len) {
+            if (pos_ + len > size_) {
+                throw ConfigError("Config cache truncated");
+            }
+            std::memcpy(out, data_ + pos_, len);
+            pos_ += len;
+        }
+    };
+
+    /**
+     * @brief Append-only writer for the snapshot
+     */
+    class Writer {
+    private:
+        std::string& out_;
+
+    public:
+        explicit Writer(std::string& out) : out_(out) {}
+
+        void u32(uint32_t v) { out_.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+        void i64(int64_t v) { out_.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+        void boolean(bool v) { out_.push_back(v ? 1 : 0); }
+        void str(const std::string& v) {
+            u32(static_cast<uint32_t>(v.size()));
+            out_.append(v);
+        }
+    };
+
+public:
+    static std::string cachePath(const std::string& json_path) {
+        return json_path + ".bin";
+    }
+
+    /**
+     * @brief Try to load a valid snapshot for the given JSON source
+     * @return Whether the snapshot was valid and decoded
+     */
+    static bool load(const std::string& json_path, GlobalConfig& out) {
+        struct stat src;
+        if (stat(json_path.c_str(), &src) != 0) {
+            return false;
+        }
+
+        int fd = open(cachePath(json_path).c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat cache;
+        if (fstat(fd, &cache) != 0 || cache.st_size < 24) {
+            close(fd);
+            return false;
+        }
+
+        void* map = mmap(nullptr, cache.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+
+        bool ok = false;
+        try {
+            Reader reader(static_cast<const char*>(map), cache.st_size);
+            if (reader.u32() == MAGIC && reader.u32() == VERSION &&
+                reader.i64() == static_cast<int64_t>(src.st_mtime) &&
+                reader.i64() == static_cast<int64_t>(src.st_size)) {
+                out = decode(reader);
+                ok = true;
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+
+        munmap(map, cache.st_size);
+        return ok;
+    }
+
+    /**
+     * @brief Write a snapshot for the given JSON source (best effort)
+     */
+    static bool store(const std::string& json_path, const GlobalConfig& config) {
+        struct stat src;
+        if (stat(json_path.c_str(), &src) != 0) {
+            return false;
+        }
+
+        std::string buffer;
+        buffer.reserve(4096);
+        Writer writer(buffer);
+        writer.u32(MAGIC);
+        writer.u32(VERSION);
+        writer.i64(static_cast<int64_t>(src.st_mtime));
+        writer.i64(static_cast<int64_t>(src.st_size));
+        encode(writer, config);
+
+        return FileUtils::write(cachePath(json_path), buffer);
+    }
+
+    /**
+     * @brief FNV-1a content hash of one environment's snapshot encoding
+     *
+     * Reloads use this to decide whether an environment actually changed;
+     * because the bytes come from the same encoder as the cache snapshot,
+     * the hash automatically covers every configured field.
+     */
+    static uint64_t hashEnvironment(const EnvironmentConfig& env) {
+        std::string buffer;
+        buffer.reserve(512);
+        Writer writer(buffer);
+        encodeEnvironment(writer, env);
+
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : buffer) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+private:
+    static void encode(Writer& w, const GlobalConfig& c) {
+        w.str(c.app_name);
+        w.str(c.version);
+        w.str(c.base_path);
+        w.str(c.config_path);
+        w.str(c.log_path);
+        w.str(c.template_path);
+        w.str(c.log_level);
+        w.boolean(c.daemonize);
+        w.str(c.pid_file);
+        w.u32(static_cast<uint32_t>(c.port_range_start));
+        w.u32(static_cast<uint32_t>(c.port_range_end));
+        w.u32(static_cast<uint32_t>(c.metrics_interval));
+
+        w.u32(static_cast<uint32_t>(c.environments.size()));
+        for (const auto& env : c.environments) {
+            encodeEnvironment(w, env);
+        }
+    }
+
+    static void encodeEnvironment(Writer& w, const EnvironmentConfig& env) {
+        w.str(env.name);
+        w.str(env.description);
+        w.str(env.os_template);
+        w.str(env.architecture);
+        w.str(env.root_path);
+        w.str(env.data_path);
+
+        w.u32(static_cast<uint32_t>(env.ssh.port));
+        w.str(env.ssh.listen_address);
+        w.str(env.ssh.root_password);
+        w.boolean(env.ssh.password_auth);
+        w.boolean(env.ssh.pubkey_auth);
+        w.u32(static_cast<uint32_t>(env.ssh.max_auth_tries));
+        w.u32(static_cast<uint32_t>(env.ssh.client_alive_interval));
+        w.str(env.ssh.banner_message);
+
+        w.i64(env.limits.max_cpu_time);
+        w.i64(env.limits.max_memory);
+        w.i64(env.limits.max_file_size);
+        w.u32(static_cast<uint32_t>(env.limits.max_processes));
+        w.u32(static_cast<uint32_t>(env.limits.max_open_files));
+
+        w.u32(static_cast<uint32_t>(env.mounts.size()));
+        for (const auto& mount : env.mounts) {
+            w.str(mount.source);
+            w.str(mount.target);
+            w.str(mount.type);
+            w.i64(static_cast<int64_t>(mount.flags));
+            w.boolean(mount.read_only);
+        }
+
+        w.u32(static_cast<uint32_t>(env.users.size()));
+        for (const auto& user : env.users) {
+            w.str(user.name);
+            w.str(user.shell);
+            w.str(user.home);
+            w.boolean(user.sudo);
+        }
+
+        w.u32(static_cast<uint32_t>(env.environment.size()));
+        for (const auto& [key, value] : env.environment) {
+            w.str(key);
+            w.str(value);
+        }
+
+        w.str(env.init_script);
+        w.str(env.cleanup_script);
+        w.boolean(env.enabled);
+    }
+
+    static GlobalConfig decode(Reader& r) {
+        GlobalConfig c;
+        c.app_name = r.str();
+        c.version = r.str();
+        c.base_path = r.str();
+        c.config_path = r.str();
+        c.log_path = r.str();
+        c.template_path = r.str();
+        c.log_level = r.str();
+        c.daemonize = r.boolean();
+        c.pid_file = r.str();
+        c.port_range_start = static_cast<int>(r.u32());
+        c.port_range_end = static_cast<int>(r.u32());
+        c.metrics_interval = static_cast<int>(r.u32());
+
+        uint32_t env_count = r.u32();
+        c.environments.reserve(env_count);
+        for (uint32_t i = 0; i < env_count; ++i) {
+            EnvironmentConfig env;
+            env.name = r.str();
+            env.description = r.str();
+            env.os_template = r.str();
+            env.architecture = r.str();
+            env.root_path = r.str();
+            env.data_path = r.str();
+
+            env.ssh.port = static_cast<int>(r.u32());
+            env.ssh.listen_address = r.str();
+            env.ssh.root_password = r.str();
+            env.ssh.password_auth = r.boolean();
+            env.ssh.pubkey_auth = r.boolean();
+            env.ssh.max_auth_tries = static_cast<int>(r.u32());
+            env.ssh.client_alive_interval = static_cast<int>(r.u32());
+            env.ssh.banner_message = r.str();
+
+            env.limits.max_cpu_time = r.i64();
+            env.limits.max_memory = r.i64();
+            env.limits.max_file_size = r.i64();
+            env.limits.max_processes = static_cast<int>(r.u32());
+            env.limits.max_open_files = static_cast<int>(r.u32());
+
+            uint32_t mount_count = r.u32();
+            env.mounts.reserve(mount_count);
+            for (uint32_t m = 0; m < mount_count; ++m) {
+                MountPoint mount;
+                mount.source = r.str();
+                mount.target = r.str();
+                mount.type = r.str();
+                mount.flags = static_cast<unsigned long>(r.i64());
+                mount.read_only = r.boolean();
+                env.mounts.push_back(std::move(mount));
+            }
+
+            uint32_t user_count = r.u32();
+            env.users.reserve(user_count);
+            for (uint32_t u = 0; u < user_count; ++u) {
+                UserConfig user;
+                user.name = r.str();
+                user.shell = r.str();
+                user.home = r.str();
+                user.sudo = r.boolean();
+                env.users.push_back(std::move(user));
+            }
+
+            uint32_t var_count = r.u32();
+            for (uint32_t v = 0; v < var_count; ++v) {
+                std::string key = r.str();
+                env.environment[key] = r.str();
+            }
+
+            env.init_script = r.str();
+            env.cleanup_script = r.str();
+            env.enabled = r.boolean();
+
+            c.environments.push_back(std::move(env));
+        }
+
+        return c;
+    }
+};
+
+/**
+ * @brief Names of environments that differ between two loaded configs
+ *
+ * Produced by ConfigManager::reload() so callers can touch only the
+ * jails whose configuration actually moved.
+ */
+struct ReloadDelta {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<std::string> changed;
+};
+
 /**
  * @brief Configuration manager
  */
@@ -500,11 +971,15 @@ private:
     GlobalConfig config_;
     std::string config_file_;
     std::string error_;
+
+    // Name -> index into config_.environments, rebuilt on load
+    std::unordered_map<std::string, size_t> env_index_;
     
 public:
     ConfigManager() : config_file_("/etc/agi/agi_config.json") {}
     
     bool load(const std::string& path = "") {
+        AGI_PERF_SCOPE("config.load");
         if (!path.empty()) {
             config_file_ = path;
         }
@@ -514,17 +989,37 @@ public:
             return false;
         }
         
+        // Fast path: valid binary snapshot of the last successful parse
+        if (ConfigBinaryCache::load(config_file_, config_)) {
+            rebuildIndex();
+            error_.clear();
+            return true;
+        }
+
         try {
-            std::string content = FileUtils::read(config_file_);
-            JsonValue json = JsonParser::parseFromString(content);
-            
+            // Parse straight off the mapped file; the document is never
+            // copied into a string
+            MappedFile mapped = FileUtils::readMapped(config_file_);
+            if (!mapped.valid()) {
+                error_ = "Cannot open configuration file: " + config_file_;
+                return false;
+            }
+
+            JsonParser parser(mapped.view());
+            JsonValue json = parser.parse();
+
             if (!json.isObject()) {
                 error_ = "Root element of configuration file must be an object";
                 return false;
             }
-            
+
+            config_ = GlobalConfig{};
             parseGlobalConfig(json.asObject());
+            rebuildIndex();
             error_.clear();
+
+            // Refresh the snapshot so the next load skips the JSON parse
+            ConfigBinaryCache::store(config_file_, config_);
             return true;
             
         } catch (const std::exception& e) {
@@ -533,18 +1028,87 @@ public:
         }
     }
     
+    /**
+     * @brief Re-load the config file and report what changed
+     *
+     * Environments are compared by name and content hash against the
+     * previously loaded config, so the caller can apply just the delta
+     * instead of rebuilding its world. A failed load restores the
+     * previous config untouched and returns false.
+     *
+     * On success the displaced config is handed to the caller via
+     * `previous`: live JailManagers still point into its environments
+     * vector until the pool rebinds them, so the caller must keep it
+     * alive through applyReload() (or push it back with
+     * restoreConfig() to abandon the reload).
+     */
+    bool reload(ReloadDelta& delta, GlobalConfig& previous) {
+        AGI_PERF_SCOPE("config.reload");
+        delta = ReloadDelta{};
+
+        // Hash the current environments before load() replaces them
+        std::unordered_map<std::string, uint64_t> old_hashes;
+        old_hashes.reserve(config_.environments.size());
+        for (const auto& env : config_.environments) {
+            old_hashes[env.name] = ConfigBinaryCache::hashEnvironment(env);
+        }
+
+        previous = std::move(config_);
+        if (!load()) {
+            config_ = std::move(previous);
+            rebuildIndex();
+            return false;
+        }
+
+        for (const auto& env : config_.environments) {
+            auto it = old_hashes.find(env.name);
+            if (it == old_hashes.end()) {
+                delta.added.push_back(env.name);
+                continue;
+            }
+            if (it->second != ConfigBinaryCache::hashEnvironment(env)) {
+                delta.changed.push_back(env.name);
+            }
+            old_hashes.erase(it);
+        }
+        for (const auto& [name, hash] : old_hashes) {
+            (void)hash;
+            delta.removed.push_back(name);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Abandon a reload by reinstating the displaced config
+     *
+     * Used when post-reload validation fails: the jails were never
+     * rebound, so their pointers into this vector become valid again.
+     */
+    void restoreConfig(GlobalConfig&& previous) {
+        config_ = std::move(previous);
+        rebuildIndex();
+    }
+
     bool save(const std::string& path = "") {
         std::string outputPath = path.empty() ? config_file_ : path;
         
         try {
             JsonValue json = serializeToJson();
-            std::string content = json.serialize(2);
-            
-            if (!FileUtils::write(outputPath, content)) {
+
+            // Stream straight to the file; the document is never
+            // materialized as one string
+            std::ofstream file(outputPath);
+            if (!file.is_open()) {
                 error_ = "Cannot write configuration file: " + outputPath;
                 return false;
             }
-            
+            json.serialize(file, 2);
+
+            if (!file.good()) {
+                error_ = "Cannot write configuration file: " + outputPath;
+                return false;
+            }
+
             return true;
         } catch (const std::exception& e) {
             error_ = std::string("Configuration save error: ") + e.what();
@@ -566,19 +1130,34 @@ public:
             return false;
         }
         
+        if (config_.port_range_start < 1 || config_.port_range_end > 65535 ||
+            config_.port_range_start > config_.port_range_end) {
+            error_ = "Port range must satisfy 1 <= start <= end <= 65535";
+            return false;
+        }
+
+        // One-pass port conflict scan across every environment; the
+        // full-range bitmap costs 8 KB and makes each check O(1)
+        PortRegistry used(1, 65535);
+
         // Check environment configurations
         for (const auto& env : config_.environments) {
             if (env.name.empty()) {
                 error_ = "Environment name cannot be empty";
                 return false;
             }
-            
-            // Check port range
-            if (env.ssh.port < 1 || env.ssh.port > 65535) {
+
+            // Check port range; 0 means "assign from the registry on create"
+            if (env.ssh.port < 0 || env.ssh.port > 65535) {
                 error_ = "SSH port must be in range 1-65535";
                 return false;
             }
-            
+            if (env.ssh.port != 0 && !used.reserve(env.ssh.port)) {
+                error_ = "Duplicate SSH port " + std::to_string(env.ssh.port) +
+                         " in environment: " + env.name;
+                return false;
+            }
+
             // Check path safety
             std::string unsafePath = "/etc,/var/lib,/var/run";
             for (const auto& mount : env.mounts) {
@@ -594,14 +1173,60 @@ public:
         return true;
     }
     
-    const EnvironmentConfig* findEnvironment(const std::string& name) const {
+    /**
+     * @brief Build the port registry for the configured allocation range
+     *
+     * Configured environment ports inside the range are marked taken,
+     * then the persisted snapshot next to the config is merged in so
+     * ports handed out earlier stay reserved even if the config save
+     * recording them failed.
+     */
+    PortRegistry buildPortRegistry() const {
+        PortRegistry registry(config_.port_range_start, config_.port_range_end);
         for (const auto& env : config_.environments) {
-            if (env.name == name) {
-                return &env;
-            }
+            registry.reserve(env.ssh.port);
+        }
+        registry.load(PortRegistry::registryPath(config_file_));
+        return registry;
+    }
+
+    /**
+     * @brief Allocate a free SSH port from the configured range
+     * @return The reserved port, or -1 if the range is exhausted
+     *
+     * The updated registry snapshot is persisted before returning, so
+     * the port cannot be handed out twice.
+     */
+    int allocatePort() {
+        PortRegistry registry = buildPortRegistry();
+        int port = registry.allocate();
+        if (port > 0) {
+            registry.store(PortRegistry::registryPath(config_file_));
+        }
+        return port;
+    }
+
+    /**
+     * @brief O(1) environment lookup via the name index
+     */
+    const EnvironmentConfig* findEnvironment(const std::string& name) const {
+        auto it = env_index_.find(name);
+        if (it != env_index_.end() && it->second < config_.environments.size()) {
+            return &config_.environments[it->second];
         }
         return nullptr;
     }
+
+    /**
+     * @brief Rebuild the name index after mutating environments directly
+     */
+    void rebuildIndex() {
+        env_index_.clear();
+        env_index_.reserve(config_.environments.size());
+        for (size_t i = 0; i < config_.environments.size(); ++i) {
+            env_index_[config_.environments[i].name] = i;
+        }
+    }
     
     static ConfigManager createDefault() {
         ConfigManager manager;
@@ -616,7 +1241,8 @@ public:
         devEnv.ssh.port = 2201;
         devEnv.ssh.listen_address = "127.0.0.1";
         manager.config_.environments.push_back(devEnv);
-        
+        manager.rebuildIndex();
+
         return manager;
     }
     
@@ -639,11 +1265,18 @@ private:
     
     void parseGlobalSection(const std::map<std::string, JsonValue>& global) {
         for (const auto& [key, value] : global) {
-            if (key == "base_path") config_.base_path = value.asString();
+            if (key == "app_name") config_.app_name = value.asString();
+            else if (key == "version") config_.version = value.asString();
+            else if (key == "base_path") config_.base_path = value.asString();
+            else if (key == "config_path") config_.config_path = value.asString();
             else if (key == "log_path") config_.log_path = value.asString();
             else if (key == "template_path") config_.template_path = value.asString();
             else if (key == "log_level") config_.log_level = value.asString();
             else if (key == "daemonize") config_.daemonize = value.asBool();
+            else if (key == "pid_file") config_.pid_file = value.asString();
+            else if (key == "port_range_start") config_.port_range_start = static_cast<int>(value.asNumber());
+            else if (key == "port_range_end") config_.port_range_end = static_cast<int>(value.asNumber());
+            else if (key == "metrics_interval") config_.metrics_interval = static_cast<int>(value.asNumber());
         }
     }
     
@@ -659,14 +1292,47 @@ private:
             if (envObj.count("description")) env.description = envObj.at("description").asString();
             if (envObj.count("os_template")) env.os_template = envObj.at("os_template").asString();
             if (envObj.count("architecture")) env.architecture = envObj.at("architecture").asString();
-            
+            if (envObj.count("root_path")) env.root_path = envObj.at("root_path").asString();
+            if (envObj.count("data_path")) env.data_path = envObj.at("data_path").asString();
+
             // SSH configuration
             if (envObj.count("ssh")) {
                 const auto& sshObj = envObj.at("ssh").asObject();
                 if (sshObj.count("port")) env.ssh.port = static_cast<int>(sshObj.at("port").asNumber());
                 if (sshObj.count("listen_address")) env.ssh.listen_address = sshObj.at("listen_address").asString();
+                if (sshObj.count("root_password")) env.ssh.root_password = sshObj.at("root_password").asString();
+                if (sshObj.count("password_auth")) env.ssh.password_auth = sshObj.at("password_auth").asBool();
+                if (sshObj.count("pubkey_auth")) env.ssh.pubkey_auth = sshObj.at("pubkey_auth").asBool();
+                if (sshObj.count("max_auth_tries")) env.ssh.max_auth_tries = static_cast<int>(sshObj.at("max_auth_tries").asNumber());
+                if (sshObj.count("client_alive_interval")) env.ssh.client_alive_interval = static_cast<int>(sshObj.at("client_alive_interval").asNumber());
+                if (sshObj.count("banner_message")) env.ssh.banner_message = sshObj.at("banner_message").asString();
             }
-            
+
+            // Resource limits
+            if (envObj.count("limits")) {
+                const auto& limObj = envObj.at("limits").asObject();
+                if (limObj.count("max_cpu_time")) env.limits.max_cpu_time = static_cast<int64_t>(limObj.at("max_cpu_time").asNumber());
+                if (limObj.count("max_memory")) env.limits.max_memory = static_cast<int64_t>(limObj.at("max_memory").asNumber());
+                if (limObj.count("max_file_size")) env.limits.max_file_size = static_cast<int64_t>(limObj.at("max_file_size").asNumber());
+                if (limObj.count("max_processes")) env.limits.max_processes = static_cast<int>(limObj.at("max_processes").asNumber());
+                if (limObj.count("max_open_files")) env.limits.max_open_files = static_cast<int>(limObj.at("max_open_files").asNumber());
+            }
+
+            // Mount points
+            if (envObj.count("mounts")) {
+                for (const auto& mountJson : envObj.at("mounts").asArray()) {
+                    if (!mountJson.isObject()) continue;
+                    const auto& mountObj = mountJson.asObject();
+                    MountPoint mount;
+                    if (mountObj.count("source")) mount.source = mountObj.at("source").asString();
+                    if (mountObj.count("target")) mount.target = mountObj.at("target").asString();
+                    if (mountObj.count("type")) mount.type = mountObj.at("type").asString();
+                    if (mountObj.count("flags")) mount.flags = static_cast<unsigned long>(mountObj.at("flags").asNumber());
+                    if (mountObj.count("read_only")) mount.read_only = mountObj.at("read_only").asBool();
+                    env.mounts.push_back(std::move(mount));
+                }
+            }
+
             // User configuration
             if (envObj.count("users")) {
                 for (const auto& userJson : envObj.at("users").asArray()) {
@@ -674,22 +1340,50 @@ private:
                     const auto& userObj = userJson.asObject();
                     UserConfig user;
                     if (userObj.count("name")) user.name = userObj.at("name").asString();
+                    if (userObj.count("shell")) user.shell = userObj.at("shell").asString();
+                    if (userObj.count("home")) user.home = userObj.at("home").asString();
+                    if (userObj.count("sudo")) user.sudo = userObj.at("sudo").asBool();
                     env.users.push_back(user);
                 }
             }
-            
+
+            // Environment variables
+            if (envObj.count("environment")) {
+                for (const auto& [var, val] : envObj.at("environment").asObject()) {
+                    env.environment[var] = val.asString();
+                }
+            }
+
+            if (envObj.count("init_script")) env.init_script = envObj.at("init_script").asString();
+            if (envObj.count("cleanup_script")) env.cleanup_script = envObj.at("cleanup_script").asString();
+            if (envObj.count("enabled")) env.enabled = envObj.at("enabled").asBool();
+
             config_.environments.push_back(env);
         }
     }
     
+    /**
+     * @brief Serialize the full config, field for field
+     *
+     * Must stay lossless against parseGlobalConfig: save() rewrites the
+     * operator's file, so any field parsed but not written here would
+     * be silently destroyed by the first save.
+     */
     JsonValue serializeToJson() const {
-        JsonValue global(JsonValue::ValueType(std::map<std::string, JsonValue>{}));
+        JsonValue global(std::map<std::string, JsonValue>{});
+        global["app_name"] = config_.app_name;
+        global["version"] = config_.version;
         global["base_path"] = config_.base_path;
+        global["config_path"] = config_.config_path;
         global["log_path"] = config_.log_path;
         global["template_path"] = config_.template_path;
         global["log_level"] = config_.log_level;
         global["daemonize"] = config_.daemonize;
-        
+        global["pid_file"] = config_.pid_file;
+        global["port_range_start"] = static_cast<double>(config_.port_range_start);
+        global["port_range_end"] = static_cast<double>(config_.port_range_end);
+        global["metrics_interval"] = static_cast<double>(config_.metrics_interval);
+
         JsonValue envArray(std::vector<JsonValue>{});
         for (const auto& env : config_.environments) {
             JsonValue envJson(std::map<std::string, JsonValue>{});
@@ -697,20 +1391,68 @@ private:
             envJson["description"] = env.description;
             envJson["os_template"] = env.os_template;
             envJson["architecture"] = env.architecture;
+            envJson["root_path"] = env.root_path;
+            envJson["data_path"] = env.data_path;
             envJson["enabled"] = env.enabled;
-            
+
             JsonValue sshObj(std::map<std::string, JsonValue>{});
-            sshObj["port"] = env.ssh.port;
+            sshObj["port"] = static_cast<double>(env.ssh.port);
             sshObj["listen_address"] = env.ssh.listen_address;
+            sshObj["root_password"] = env.ssh.root_password;
+            sshObj["password_auth"] = env.ssh.password_auth;
+            sshObj["pubkey_auth"] = env.ssh.pubkey_auth;
+            sshObj["max_auth_tries"] = static_cast<double>(env.ssh.max_auth_tries);
+            sshObj["client_alive_interval"] = static_cast<double>(env.ssh.client_alive_interval);
+            sshObj["banner_message"] = env.ssh.banner_message;
             envJson["ssh"] = sshObj;
-            
-            envArray.asArray().push_back(envJson);
+
+            JsonValue limObj(std::map<std::string, JsonValue>{});
+            limObj["max_cpu_time"] = static_cast<double>(env.limits.max_cpu_time);
+            limObj["max_memory"] = static_cast<double>(env.limits.max_memory);
+            limObj["max_file_size"] = static_cast<double>(env.limits.max_file_size);
+            limObj["max_processes"] = static_cast<double>(env.limits.max_processes);
+            limObj["max_open_files"] = static_cast<double>(env.limits.max_open_files);
+            envJson["limits"] = limObj;
+
+            JsonValue mountArray(std::vector<JsonValue>{});
+            for (const auto& mount : env.mounts) {
+                JsonValue mountJson(std::map<std::string, JsonValue>{});
+                mountJson["source"] = mount.source;
+                mountJson["target"] = mount.target;
+                mountJson["type"] = mount.type;
+                mountJson["flags"] = static_cast<double>(mount.flags);
+                mountJson["read_only"] = mount.read_only;
+                mountArray.asArray().push_back(std::move(mountJson));
+            }
+            envJson["mounts"] = std::move(mountArray);
+
+            JsonValue userArray(std::vector<JsonValue>{});
+            for (const auto& user : env.users) {
+                JsonValue userJson(std::map<std::string, JsonValue>{});
+                userJson["name"] = user.name;
+                userJson["shell"] = user.shell;
+                userJson["home"] = user.home;
+                userJson["sudo"] = user.sudo;
+                userArray.asArray().push_back(std::move(userJson));
+            }
+            envJson["users"] = std::move(userArray);
+
+            JsonValue varsObj(std::map<std::string, JsonValue>{});
+            for (const auto& [var, val] : env.environment) {
+                varsObj[var] = val;
+            }
+            envJson["environment"] = std::move(varsObj);
+
+            envJson["init_script"] = env.init_script;
+            envJson["cleanup_script"] = env.cleanup_script;
+
+            envArray.asArray().push_back(std::move(envJson));
         }
-        
+
         JsonValue result(std::map<std::string, JsonValue>{});
         result["global"] = global;
         result["environments"] = envArray;
-        
+
         return result;
     }
 };
@@ -0,0 +1,357 @@
+/**
+ * @file daemon.hpp
+ * @brief Resident daemon mode: persistent command server over a Unix socket
+ * @author AGI Team
+ * @version 1.0.0
+ * @date 2025-12-28
+ */
+
+#ifndef AGI_DAEMON_HPP
+#define AGI_DAEMON_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+
+#include "utils.hpp"
+#include "logger.hpp"
+
+namespace agi {
+
+/**
+ * @brief Default daemon socket path
+ */
+constexpr const char* DAEMON_SOCKET_PATH = "/var/run/agi.sock";
+
+/**
+ * @brief End-of-response marker sent by the daemon
+ *
+ * The line "\x04<exit code>" terminates every response so the client
+ * can separate command output from the result status.
+ */
+constexpr char DAEMON_STATUS_MARKER = '\x04';
+
+/**
+ * @brief Command server holding a resident JailManagerPool
+ *
+ * The server accepts connections on a Unix domain socket, reads one
+ * request line per connection ("command arg1 arg2 ..."), and dispatches
+ * it through the same handler the CLI uses. Command output is redirected
+ * to the client connection for the duration of the request, so the
+ * existing cmd* functions work unchanged. Config parsing and pool
+ * construction are paid once at daemon startup instead of per call.
+ */
+class DaemonServer {
+public:
+    using CommandHandler = std::function<bool(const std::string&,
+                                              const std::vector<std::string>&)>;
+
+private:
+    std::string socket_path_;
+    std::string pid_file_;
+    CommandHandler handler_;
+    int listen_fd_ = -1;
+
+    static std::atomic<bool>& stopFlag() {
+        static std::atomic<bool> flag{false};
+        return flag;
+    }
+
+public:
+    DaemonServer(const std::string& socket_path, const std::string& pid_file,
+                 CommandHandler handler)
+        : socket_path_(socket_path), pid_file_(pid_file),
+          handler_(std::move(handler)) {}
+
+    ~DaemonServer() {
+        shutdown();
+    }
+
+    /**
+     * @brief Run the accept loop until SIGINT/SIGTERM
+     * @return Whether the server terminated cleanly
+     */
+    bool run() {
+        if (!setup()) {
+            return false;
+        }
+
+        AGI_LOG_INFO("Daemon listening on " + socket_path_);
+
+        while (!stopFlag()) {
+            int client = accept(listen_fd_, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                AGI_LOG_ERROR(std::string("accept failed: ") + strerror(errno));
+                break;
+            }
+
+            handleClient(client);
+            close(client);
+        }
+
+        shutdown();
+        AGI_LOG_INFO("Daemon stopped");
+        return true;
+    }
+
+    /**
+     * @brief Request loop termination (signal-safe)
+     */
+    static void requestStop() {
+        stopFlag() = true;
+    }
+
+private:
+    /**
+     * @brief Whether another daemon is accepting on the socket path
+     *
+     * A stale socket file refuses the connect (ECONNREFUSED); a live
+     * daemon accepts it. Anything else (missing file, permissions) is
+     * left for bind() to report.
+     */
+    static bool socketAnswers(const std::string& path) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+        bool answered = connect(fd, reinterpret_cast<sockaddr*>(&addr),
+                                sizeof(addr)) == 0;
+        close(fd);
+        return answered;
+    }
+
+    bool setup() {
+        // Only remove a socket nobody answers on; unlinking a live
+        // daemon's socket would silently steal its clients
+        if (socketAnswers(socket_path_)) {
+            AGI_LOG_ERROR("Another daemon is already listening on " + socket_path_);
+            std::cerr << "Error: daemon already running on " << socket_path_ << std::endl;
+            return false;
+        }
+        unlink(socket_path_.c_str());
+
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            AGI_LOG_ERROR(std::string("Cannot create socket: ") + strerror(errno));
+            return false;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            AGI_LOG_ERROR(std::string("Cannot bind socket: ") + strerror(errno));
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+
+        // Only root may drive the daemon, same as the CLI itself
+        chmod(socket_path_.c_str(), 0600);
+
+        if (listen(listen_fd_, 16) < 0) {
+            AGI_LOG_ERROR(std::string("Cannot listen on socket: ") + strerror(errno));
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+
+        if (!pid_file_.empty()) {
+            FileUtils::write(pid_file_, std::to_string(getpid()) + "\n");
+        }
+
+        // sigaction without SA_RESTART, so the blocking accept() in
+        // run() returns EINTR and the stop flag is acted on promptly;
+        // glibc's signal() would install BSD semantics and restart it
+        struct sigaction sa{};
+        sa.sa_handler = [](int) { requestStop(); };
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = 0;
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+        signal(SIGPIPE, SIG_IGN);
+
+        return true;
+    }
+
+    void shutdown() {
+        if (listen_fd_ >= 0) {
+            close(listen_fd_);
+            listen_fd_ = -1;
+            unlink(socket_path_.c_str());
+            if (!pid_file_.empty()) {
+                unlink(pid_file_.c_str());
+            }
+        }
+    }
+
+    void handleClient(int client) {
+        std::string request = readLine(client);
+        if (request.empty()) {
+            return;
+        }
+
+        std::vector<std::string> parts = StringUtils::split(request, ' ');
+        if (parts.empty()) {
+            return;
+        }
+
+        std::string command = parts[0];
+        std::vector<std::string> args(parts.begin() + 1, parts.end());
+
+        AGI_LOG_DEBUG("Daemon request: " + request);
+
+        // Redirect stdout/stderr to the client for the duration of the
+        // command so the existing cmd* handlers need no changes
+        int saved_out = dup(STDOUT_FILENO);
+        int saved_err = dup(STDERR_FILENO);
+        dup2(client, STDOUT_FILENO);
+        dup2(client, STDERR_FILENO);
+
+        bool ok = false;
+        try {
+            ok = handler_(command, args);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        dup2(saved_out, STDOUT_FILENO);
+        dup2(saved_err, STDERR_FILENO);
+        close(saved_out);
+        close(saved_err);
+
+        std::string status;
+        status += DAEMON_STATUS_MARKER;
+        status += (ok ? "0" : "1");
+        status += "\n";
+        writeAll(client, status);
+    }
+
+    static std::string readLine(int fd) {
+        std::string line;
+        char c;
+        while (read(fd, &c, 1) == 1) {
+            if (c == '\n') {
+                break;
+            }
+            line += c;
+        }
+        return line;
+    }
+
+    static void writeAll(int fd, const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n <= 0) {
+                break;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+};
+
+/**
+ * @brief Thin client side of the daemon protocol
+ *
+ * When a daemon is running, the CLI forwards the command over the socket
+ * and streams the response instead of parsing the config and rebuilding
+ * the pool locally.
+ */
+class DaemonClient {
+public:
+    /**
+     * @brief Try to forward a command to a running daemon
+     * @param command Command name
+     * @param args Command arguments
+     * @param exit_code Receives the command exit code on success
+     * @return Whether a daemon handled the command
+     */
+    static bool trySend(const std::string& command,
+                        const std::vector<std::string>& args,
+                        int& exit_code,
+                        const std::string& socket_path = DAEMON_SOCKET_PATH) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return false;
+        }
+
+        std::string request = command;
+        for (const auto& arg : args) {
+            request += " " + arg;
+        }
+        request += "\n";
+
+        if (write(fd, request.data(), request.size()) < 0) {
+            close(fd);
+            return false;
+        }
+
+        exit_code = 1;
+        std::string pending;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            pending.append(buffer, static_cast<size_t>(n));
+            flushOutput(pending, exit_code);
+        }
+        flushOutput(pending, exit_code);
+        if (!pending.empty()) {
+            std::cout << pending;
+        }
+        std::cout.flush();
+
+        close(fd);
+        return true;
+    }
+
+private:
+    // Print complete lines, consuming the trailing status marker line
+    static void flushOutput(std::string& pending, int& exit_code) {
+        size_t pos;
+        while ((pos = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, pos + 1);
+            pending.erase(0, pos + 1);
+
+            if (!line.empty() && line[0] == DAEMON_STATUS_MARKER) {
+                if (line.size() > 1) {
+                    exit_code = line[1] - '0';
+                }
+                continue;
+            }
+            std::cout << line;
+        }
+    }
+};
+
+} // namespace agi
+
+#endif // AGI_DAEMON_HPP
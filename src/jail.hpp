@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -21,6 +22,7 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <csignal>
 #include <cstdio>
@@ -30,16 +32,24 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <sys/mount.h>
 #include <sys/resource.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <errno.h>
+#include <elf.h>
+#include <dirent.h>
 
 #include "utils.hpp"
 #include "config.hpp"
+#include "stats.hpp"
 
 namespace agi {
 
@@ -73,6 +83,21 @@ struct MountInfo {
     std::string options;
 };
 
+/**
+ * @brief Persistent jail state record written into run_path_
+ *
+ * Lets a fresh agi process see jails started by a previous invocation:
+ * status is derived from this record plus a cheap liveness probe
+ * instead of defaulting to STOPPED.
+ */
+struct JailStateRecord {
+    uint32_t magic = 0x4A41494C;  // "JAIL"
+    uint32_t version = 1;
+    int32_t pid = -1;
+    int32_t ssh_port = -1;
+    int64_t start_time = 0;       // epoch seconds
+};
+
 /**
  * @brief Jail runtime information
  */
@@ -87,6 +112,517 @@ struct JailRuntimeInfo {
     std::string error_message;
 };
 
+/**
+ * @brief Native ELF shared-library dependency walker
+ *
+ * Parses DT_NEEDED entries straight out of each binary's dynamic
+ * segment, resolves sonames through a parsed /etc/ld.so.cache (with a
+ * per-architecture directory scan as fallback) and returns the
+ * deduplicated transitive closure, including the PT_INTERP dynamic
+ * linker. 64-bit ELF only, matching everything we ship.
+ */
+class ElfDeps {
+public:
+    /**
+     * @brief Transitive shared-library closure of the given binaries
+     * @param binaries Absolute paths of the executables to walk
+     * @param architecture Environment architecture (x86_64, aarch64);
+     *        used to pick the matching ld.so cache entries
+     * @return Absolute paths of every required library
+     */
+    static std::set<std::string> closure(
+            const std::vector<std::string>& binaries,
+            const std::string& architecture = "") {
+        std::set<std::string> libs;
+        std::set<std::string> seen_sonames;
+        std::vector<std::string> queue;
+
+        auto enqueue = [&](const std::vector<std::string>& needed) {
+            for (const auto& soname : needed) {
+                if (seen_sonames.insert(soname).second) {
+                    queue.push_back(soname);
+                }
+            }
+        };
+
+        for (const auto& bin : binaries) {
+            std::vector<std::string> needed;
+            std::string interp;
+            if (!parseElf(bin, needed, interp)) {
+                continue;
+            }
+            if (!interp.empty()) {
+                libs.insert(interp);
+            }
+            enqueue(needed);
+        }
+
+        const std::vector<std::string>& dirs = searchDirs(architecture);
+        while (!queue.empty()) {
+            std::string soname = std::move(queue.back());
+            queue.pop_back();
+
+            std::string path = resolve(soname, architecture, dirs);
+            if (path.empty() || !libs.insert(path).second) {
+                continue;
+            }
+
+            std::vector<std::string> needed;
+            std::string interp;
+            if (parseElf(path, needed, interp)) {
+                enqueue(needed);
+            }
+        }
+        return libs;
+    }
+
+private:
+    /**
+     * @brief Extract DT_NEEDED sonames and the PT_INTERP path
+     */
+    static bool parseElf(const std::string& path,
+                         std::vector<std::string>& needed,
+                         std::string& interp) {
+        MappedFile mapped = FileUtils::readMapped(path);
+        if (!mapped.valid() || mapped.size() < sizeof(Elf64_Ehdr)) {
+            return false;
+        }
+
+        const unsigned char* data =
+            reinterpret_cast<const unsigned char*>(mapped.data());
+        if (std::memcmp(data, ELFMAG, SELFMAG) != 0 ||
+            data[EI_CLASS] != ELFCLASS64) {
+            return false;
+        }
+
+        Elf64_Ehdr eh;
+        std::memcpy(&eh, data, sizeof(eh));
+        if (eh.e_phoff == 0 || eh.e_phentsize < sizeof(Elf64_Phdr) ||
+            eh.e_phoff + static_cast<uint64_t>(eh.e_phnum) * eh.e_phentsize >
+                mapped.size()) {
+            return false;
+        }
+
+        struct Load { uint64_t vaddr, off, filesz; };
+        std::vector<Load> loads;
+        uint64_t dyn_off = 0, dyn_size = 0;
+
+        for (int i = 0; i < eh.e_phnum; ++i) {
+            Elf64_Phdr ph;
+            std::memcpy(&ph, data + eh.e_phoff +
+                        static_cast<uint64_t>(i) * eh.e_phentsize, sizeof(ph));
+            if (ph.p_type == PT_LOAD) {
+                loads.push_back({ph.p_vaddr, ph.p_offset, ph.p_filesz});
+            } else if (ph.p_type == PT_DYNAMIC) {
+                dyn_off = ph.p_offset;
+                dyn_size = ph.p_filesz;
+            } else if (ph.p_type == PT_INTERP &&
+                       ph.p_offset + ph.p_filesz <= mapped.size()) {
+                const char* str =
+                    reinterpret_cast<const char*>(data + ph.p_offset);
+                interp.assign(str, strnlen(str, ph.p_filesz));
+            }
+        }
+
+        if (dyn_off == 0 || dyn_off + dyn_size > mapped.size()) {
+            // Statically linked: nothing needed
+            return true;
+        }
+
+        auto toOffset = [&loads](uint64_t vaddr) -> uint64_t {
+            for (const Load& l : loads) {
+                if (vaddr >= l.vaddr && vaddr < l.vaddr + l.filesz) {
+                    return l.off + (vaddr - l.vaddr);
+                }
+            }
+            return UINT64_MAX;
+        };
+
+        std::vector<uint64_t> needed_offsets;
+        uint64_t strtab_vaddr = 0;
+        for (uint64_t o = dyn_off;
+             o + sizeof(Elf64_Dyn) <= dyn_off + dyn_size;
+             o += sizeof(Elf64_Dyn)) {
+            Elf64_Dyn dyn;
+            std::memcpy(&dyn, data + o, sizeof(dyn));
+            if (dyn.d_tag == DT_NULL) break;
+            if (dyn.d_tag == DT_NEEDED) {
+                needed_offsets.push_back(dyn.d_un.d_val);
+            } else if (dyn.d_tag == DT_STRTAB) {
+                strtab_vaddr = dyn.d_un.d_ptr;
+            }
+        }
+
+        uint64_t strtab_off = strtab_vaddr ? toOffset(strtab_vaddr)
+                                           : UINT64_MAX;
+        if (strtab_off == UINT64_MAX) {
+            return true;
+        }
+
+        for (uint64_t name_off : needed_offsets) {
+            uint64_t pos = strtab_off + name_off;
+            if (pos >= mapped.size()) continue;
+            const char* str = reinterpret_cast<const char*>(data + pos);
+            size_t len = strnlen(str, mapped.size() - pos);
+            if (len > 0 && len < mapped.size() - pos) {
+                needed.emplace_back(str, len);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief soname -> (ld.so cache entry flags, path)
+     */
+    static const std::multimap<std::string,
+                               std::pair<uint32_t, std::string>>& ldCache() {
+        static const auto cache = parseLdCache();
+        return cache;
+    }
+
+    static std::multimap<std::string, std::pair<uint32_t, std::string>>
+    parseLdCache() {
+        std::multimap<std::string, std::pair<uint32_t, std::string>> result;
+
+        MappedFile mapped = FileUtils::readMapped("/etc/ld.so.cache");
+        if (!mapped.valid()) {
+            return result;
+        }
+        const char* data = mapped.data();
+        size_t size = mapped.size();
+
+        // New-format header ("glibc-ld.so.cache1.1") sits at offset 0 on
+        // current systems but follows an old-format block on older ones
+        static const char MAGIC[] = "glibc-ld.so.cache";
+        static const char VERSION[] = "1.1";
+        const char* found = std::search(data, data + size,
+                                        MAGIC, MAGIC + sizeof(MAGIC) - 1);
+        if (found == data + size) {
+            return result;
+        }
+        size_t base = static_cast<size_t>(found - data);
+        constexpr size_t HEADER_SIZE = 48;
+        constexpr size_t ENTRY_SIZE = 24;  // flags,key,value,osversion,hwcap
+        if (base + HEADER_SIZE > size ||
+            std::memcmp(data + base + sizeof(MAGIC) - 1, VERSION, 3) != 0) {
+            return result;
+        }
+
+        uint32_t nlibs;
+        std::memcpy(&nlibs, data + base + 20, sizeof(nlibs));
+
+        for (uint32_t i = 0; i < nlibs; ++i) {
+            size_t entry = base + HEADER_SIZE + i * ENTRY_SIZE;
+            if (entry + ENTRY_SIZE > size) break;
+
+            uint32_t flags, key, value;
+            std::memcpy(&flags, data + entry, 4);
+            std::memcpy(&key, data + entry + 4, 4);
+            std::memcpy(&value, data + entry + 8, 4);
+
+            if (base + key >= size || base + value >= size) continue;
+            const char* soname = data + base + key;
+            const char* path = data + base + value;
+            size_t klen = strnlen(soname, size - base - key);
+            size_t vlen = strnlen(path, size - base - value);
+            if (klen == 0 || vlen == 0 ||
+                klen == size - base - key || vlen == size - base - value) {
+                continue;
+            }
+            result.emplace(std::string(soname, klen),
+                           std::make_pair(flags, std::string(path, vlen)));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Architecture selector bits of an ld.so cache entry
+     */
+    static uint32_t archFlag(const std::string& architecture) {
+        if (architecture == "aarch64") return 0x0a00;
+        if (architecture == "x86_64" || architecture.empty()) return 0x0300;
+        return 0;  // unknown: accept any entry
+    }
+
+    static const std::vector<std::string>& searchDirs(
+            const std::string& architecture) {
+        static std::mutex dirs_mutex;
+        static std::map<std::string, std::vector<std::string>> cache;
+
+        std::lock_guard<std::mutex> lock(dirs_mutex);
+        auto it = cache.find(architecture);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        std::string triplet =
+            (architecture.empty() ? "x86_64" : architecture) + "-linux-gnu";
+        std::vector<std::string> dirs = {
+            "/lib/" + triplet,
+            "/usr/lib/" + triplet,
+            "/lib64",
+            "/lib",
+            "/usr/lib",
+        };
+        return cache.emplace(architecture, std::move(dirs)).first->second;
+    }
+
+    static std::string resolve(const std::string& soname,
+                               const std::string& architecture,
+                               const std::vector<std::string>& dirs) {
+        uint32_t want = archFlag(architecture);
+        auto range = ldCache().equal_range(soname);
+        std::string fallback;
+        for (auto it = range.first; it != range.second; ++it) {
+            const auto& [flags, path] = it->second;
+            if (!FileUtils::exists(path)) continue;
+            if (want == 0 || (flags & 0xff00) == want) {
+                return path;
+            }
+            if (fallback.empty()) fallback = path;
+        }
+        if (!fallback.empty()) {
+            return fallback;
+        }
+
+        for (const auto& dir : dirs) {
+            std::string candidate = dir + "/" + soname;
+            if (FileUtils::exists(candidate)) {
+                return candidate;
+            }
+        }
+        return std::string();
+    }
+};
+
+/**
+ * @brief Fixed-size POD runtime snapshot published through a seqlock
+ *
+ * Writers bump the version to odd, overwrite the slot, then bump to
+ * even; readers retry on a version mismatch. A version of 0 means the
+ * jail has not published yet.
+ */
+struct JailRuntimeSlot {
+    char name[64];
+    char ip_address[46];
+    int32_t status;       // JailStatus
+    int32_t pid;
+    int32_t ssh_port;
+    int32_t mount_count;
+    int64_t start_time;   // epoch seconds
+};
+
+/**
+ * @brief One resource-usage sample of a jail's sshd, read from /proc
+ *
+ * cpu_ticks is cumulative (utime+stime in clock ticks), so rates come
+ * from differencing two samples; rss and fd counts are point-in-time.
+ */
+struct JailMetricsSample {
+    int64_t timestamp = 0;    // epoch milliseconds
+    uint64_t cpu_ticks = 0;   // cumulative utime+stime
+    int64_t rss_kb = 0;
+    int32_t fd_count = 0;
+};
+
+/**
+ * @brief Event-driven supervisor for jail child processes
+ *
+ * One background thread owns an epoll set of pidfds: every sshd, init
+ * or cleanup child is registered here and reaped asynchronously, so no
+ * caller ever blocks in waitpid and an sshd that dies on its own is
+ * noticed immediately instead of leaving a stale pid behind. Exit
+ * callbacks run on the supervisor thread; they must stay cheap and may
+ * not call back into watch() for the same pid.
+ *
+ * On kernels without pidfd_open, watch() fails and callers keep their
+ * synchronous fallback.
+ */
+class JailSupervisor {
+private:
+    struct Watch {
+        pid_t pid;
+        const void* owner;  // tag for unwatch(); may be null
+        std::function<void(int)> on_exit;
+    };
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::map<int, Watch> watches_;  // pidfd -> watch
+    std::mutex mutex_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Owner of the callback the loop is currently running, so
+    // unwatch() can wait it out before its owner is destroyed
+    const void* inflight_owner_ = nullptr;
+    std::condition_variable inflight_cv_;
+
+    JailSupervisor() = default;
+
+public:
+    static JailSupervisor& getInstance() {
+        static JailSupervisor instance;
+        return instance;
+    }
+
+    ~JailSupervisor() {
+        shutdown();
+    }
+
+    /**
+     * @brief Register a child; on_exit(status) fires after async reaping
+     * @param owner Opaque tag the callback's captures belong to; pass it
+     *              to unwatch() before destroying that object
+     * @return Whether the child is supervised (false = caller must reap)
+     */
+    bool watch(pid_t pid, std::function<void(int)> on_exit,
+               const void* owner = nullptr) {
+        if (!ensureRunning()) {
+            return false;
+        }
+
+        int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        if (pidfd < 0) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            watches_[pidfd] = {pid, owner, std::move(on_exit)};
+        }
+
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = pidfd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, pidfd, &ev) != 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            watches_.erase(pidfd);
+            close(pidfd);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Detach an owner's exit callbacks without dropping the reap
+     *
+     * The watches stay registered so their children never turn into
+     * zombies; only the callbacks, whose captures point into the owner,
+     * are cleared. Blocks until a callback for the owner that is
+     * already running has returned, so the owner may be destroyed
+     * immediately after. Must not be called from an exit callback.
+     */
+    void unwatch(const void* owner) {
+        if (!owner) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (auto& [pidfd, watch] : watches_) {
+            if (watch.owner == owner) {
+                watch.on_exit = nullptr;
+                watch.owner = nullptr;
+            }
+        }
+        inflight_cv_.wait(lock, [&] { return inflight_owner_ != owner; });
+    }
+
+private:
+    bool ensureRunning() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return true;
+        }
+
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            if (epoll_fd_ >= 0) close(epoll_fd_);
+            if (wake_fd_ >= 0) close(wake_fd_);
+            epoll_fd_ = wake_fd_ = -1;
+            return false;
+        }
+
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+        running_ = true;
+        thread_ = std::thread([this]() { loop(); });
+        return true;
+    }
+
+    void shutdown() {
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        uint64_t one = 1;
+        ssize_t n = write(wake_fd_, &one, sizeof(one));
+        (void)n;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [pidfd, watch] : watches_) {
+            close(pidfd);
+        }
+        watches_.clear();
+        close(epoll_fd_);
+        close(wake_fd_);
+        epoll_fd_ = wake_fd_ = -1;
+    }
+
+    void loop() {
+        struct epoll_event events[16];
+
+        while (running_) {
+            int n = epoll_wait(epoll_fd_, events, 16, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wake_fd_) {
+                    uint64_t drain;
+                    ssize_t r = read(wake_fd_, &drain, sizeof(drain));
+                    (void)r;
+                    continue;
+                }
+
+                Watch watch;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = watches_.find(fd);
+                    if (it == watches_.end()) {
+                        continue;
+                    }
+                    watch = std::move(it->second);
+                    watches_.erase(it);
+                    inflight_owner_ = watch.owner;
+                }
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+
+                int status = 0;
+                waitpid(watch.pid, &status, WNOHANG);
+                if (watch.on_exit) {
+                    watch.on_exit(status);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    inflight_owner_ = nullptr;
+                }
+                inflight_cv_.notify_all();
+            }
+        }
+    }
+};
+
 /**
  * @brief Chroot environment manager
  */
@@ -96,13 +632,53 @@ private:
     std::string jail_path_;
     std::string data_path_;
     std::string run_path_;
+    std::string template_path_;
+    std::string overlay_upper_;
+    std::string overlay_work_;
     
     std::atomic<JailStatus> status_{JailStatus::STOPPED};
     pid_t sshd_pid_ = -1;
+    std::atomic<pid_t> init_pid_{-1};
+
+    // Supervisor bookkeeping: whether our children are reaped
+    // asynchronously, and whether the next sshd exit was requested
+    std::atomic<bool> sshd_supervised_{false};
+    std::atomic<bool> init_supervised_{false};
+    std::atomic<bool> expecting_sshd_exit_{false};
+    bool auto_restart_ = false;
+    std::atomic<int> restart_attempts_{0};
+
+    // Pending auto-restart: the thread polls the cancel flag while it
+    // sleeps and is joined before this object may be destroyed, so the
+    // wakeup never runs against a freed jail
+    std::thread restart_thread_;
+    std::atomic<bool> restart_cancel_{false};
+    std::mutex restart_mutex_;  // guards restart_thread_
+    std::atomic<bool> shutting_down_{false};  // destructor has begun
+
+    // Seqlock-published runtime snapshot for lock-free readers
+    mutable std::atomic<uint32_t> slot_version_{0};
+    JailRuntimeSlot slot_{};
     
     std::chrono::system_clock::time_point start_time_;
     std::vector<MountInfo> active_mounts_;
     mutable std::mutex mutex_;
+
+    // TTL cache for the persistent-state probe so polling commands do
+    // one stat/kill pass every few seconds instead of per call
+    static constexpr std::chrono::seconds PROBE_TTL{2};
+    mutable bool probe_valid_ = false;
+    mutable std::chrono::steady_clock::time_point last_probe_{};
+    mutable JailStateRecord probed_record_{};
+
+    // Metrics ring: fixed capacity, newest overwrites oldest. Guarded
+    // by its own mutex so the sampler never contends with jail
+    // operations holding mutex_
+    static constexpr size_t METRICS_RING = 64;
+    mutable std::mutex metrics_mutex_;
+    JailMetricsSample metrics_ring_[METRICS_RING] = {};
+    size_t metrics_head_ = 0;
+    size_t metrics_count_ = 0;
     
     // Logger function
     std::function<void(const std::string&, const std::string&)> logger_;
@@ -112,6 +688,85 @@ public:
         jail_path_ = "/var/lib/agi/jails/" + config.name;
         data_path_ = jail_path_ + "/data";
         run_path_ = jail_path_ + "/run";
+        template_path_ = "/var/lib/agi/templates/" + config.os_template;
+        overlay_upper_ = "/var/lib/agi/overlay/" + config.name + "/upper";
+        overlay_work_ = "/var/lib/agi/overlay/" + config.name + "/work";
+    }
+
+    /**
+     * @brief Construct with an explicit jail path (warm-pool standby jails)
+     *
+     * Standby jails are always provisioned in copy mode so the whole
+     * tree can later be renamed to its claimed name in one operation.
+     */
+    JailManager(const EnvironmentConfig& config, const std::string& jail_path)
+        : config_(&config) {
+        jail_path_ = jail_path;
+        data_path_ = jail_path_ + "/data";
+        run_path_ = jail_path_ + "/run";
+        template_path_ = "";  // force copy-based provisioning
+        overlay_upper_ = jail_path_ + ".overlay/upper";
+        overlay_work_ = jail_path_ + ".overlay/work";
+    }
+
+    ~JailManager() {
+        // Supervisor callbacks capture a raw `this`, so they must all
+        // be detached (and any in-flight one waited out) before members
+        // go away. The first unwatch also stops new restarts from being
+        // scheduled; the join then collects a restart already running,
+        // and the second unwatch drops whatever its start() managed to
+        // re-register in the meantime
+        shutting_down_ = true;
+        JailSupervisor::getInstance().unwatch(this);
+        cancelPendingRestart();
+        JailSupervisor::getInstance().unwatch(this);
+    }
+
+    /**
+     * @brief Re-generate the per-environment files after a warm claim
+     *
+     * A claimed standby jail carries the template's base system; only
+     * the environment-specific pieces (sshd_config with the real port,
+     * init scripts) need rewriting.
+     */
+    bool finalizeClaim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            writeScaffoldFiles();
+            return true;
+        } catch (const std::exception& e) {
+            log("ERROR", std::string("Failed to finalize claim: ") + e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief Point this jail at the environment's slot in a reloaded config
+     *
+     * ConfigManager::reload() reallocates the environments vector, which
+     * invalidates the pointer taken at construction. Only the pointer is
+     * swapped; the jail and any running sshd are left alone. New values
+     * (a changed port, say) take effect on the next start — including
+     * the mount plan, whose cached copy is dropped here so a reloaded
+     * mounts vector is not shadowed by the memoized one.
+     */
+    void rebindConfig(const EnvironmentConfig& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = &config;
+        invalidateMountPlan(config.name);
+    }
+
+    /**
+     * @brief Drop a cached mount plan so the next start rebuilds it
+     *
+     * Called on config rebind and environment removal: a reload may
+     * have changed the environment's mounts vector, and a
+     * daemon-resident pool would otherwise replay the stale plan
+     * forever.
+     */
+    static void invalidateMountPlan(const std::string& name) {
+        std::lock_guard<std::mutex> lock(planMutex());
+        planCache().erase(name);
     }
     
     /**
@@ -121,6 +776,13 @@ public:
         logger_ = logger;
     }
     
+    /**
+     * @brief Restart sshd automatically after an unexpected exit
+     */
+    void setAutoRestart(bool enabled) {
+        auto_restart_ = enabled;
+    }
+
     void log(const std::string& level, const std::string& message) {
         if (logger_) {
             logger_(level, message);
@@ -132,26 +794,31 @@ public:
      * @return Whether successful
      */
     bool create() {
+        AGI_PERF_SCOPE("jail.create");
         std::lock_guard<std::mutex> lock(mutex_);
         
         try {
             log("INFO", "Starting to create jail environment: " + config_->name);
-            
-            // Create directory structure
-            createDirectoryStructure();
-            
-            // Copy base system files
-            copyBaseSystem();
-            
-            // Create necessary device nodes
-            createDeviceNodes();
-            
-            // Generate SSH configuration
-            generateSshConfig();
-            
-            // Create initialization scripts
-            createInitScripts();
-            
+
+            if (hasTemplate()) {
+                // Template-backed mode: the base system is a shared
+                // read-only lower layer, so creation is a metadata
+                // operation and per-jail writes land in the upper dir
+                provisionFromTemplate();
+            } else {
+                // Create directory structure
+                createDirectoryStructure();
+
+                // Copy base system files
+                copyBaseSystem();
+
+                // Create necessary device nodes
+                createDeviceNodes();
+
+                // SSH configuration and init scripts in one write burst
+                writeScaffoldFiles();
+            }
+
             log("INFO", "Jail environment created successfully: " + jail_path_);
             return true;
             
@@ -163,28 +830,53 @@ public:
     
     /**
      * @brief Destroy jail environment
+     * @param background Rename first and reclaim disk in a detached child
      * @return Whether successful
+     *
+     * In background mode the jail directories are renamed out of the
+     * way (freeing the environment name immediately) and a detached
+     * child process runs the actual deletion, so multi-minute
+     * reclamation of populated data directories never blocks the
+     * caller or the pool.
      */
-    bool destroy() {
+    bool destroy(bool background = false) {
+        // Stop first; stop() takes the jail lock itself
+        stop();
+
         std::lock_guard<std::mutex> lock(mutex_);
-        
+
         try {
-            // Stop first
-            stop();
-            
             log("INFO", "Destroying jail environment: " + config_->name);
-            
+
             // Unmount all mount points
             unmountAll();
-            
-            // Delete directory
-            if (std::filesystem::exists(jail_path_)) {
-                std::filesystem::remove_all(jail_path_);
+
+            std::string overlay_base = PathUtils::parent(overlay_upper_);
+            std::vector<std::string> doomed;
+
+            if (background) {
+                // Rename-first: the name is free as soon as this returns
+                std::string suffix = ".removed." +
+                    std::to_string(static_cast<long long>(time(nullptr))) +
+                    "." + std::to_string(getpid());
+                for (const auto& path : {jail_path_, overlay_base}) {
+                    if (std::filesystem::exists(path)) {
+                        std::filesystem::rename(path, path + suffix);
+                        doomed.push_back(path + suffix);
+                    }
+                }
+                reclaimDetached(doomed);
+            } else {
+                for (const auto& path : {jail_path_, overlay_base}) {
+                    if (std::filesystem::exists(path)) {
+                        FileUtils::removeRecursiveParallel(path);
+                    }
+                }
             }
-            
+
             log("INFO", "Jail environment has been destroyed: " + config_->name);
             return true;
-            
+
         } catch (const std::exception& e) {
             log("ERROR", std::string("Failed to destroy jail: ") + e.what());
             return false;
@@ -196,13 +888,27 @@ public:
      * @return Whether successful
      */
     bool start() {
+        AGI_PERF_SCOPE("jail.start");
         std::lock_guard<std::mutex> lock(mutex_);
         
         if (status_ == JailStatus::RUNNING) {
             log("WARN", "Jail is already running");
             return true;
         }
-        
+
+        // A previous agi process may have started this jail already
+        if (status_ == JailStatus::STOPPED) {
+            int pid = probeLocked();
+            if (pid > 0) {
+                log("WARN", "Jail is already running (PID " +
+                    std::to_string(pid) + " from a previous invocation)");
+                sshd_pid_ = pid;
+                status_ = JailStatus::RUNNING;
+                publishSlotLocked();
+                return true;
+            }
+        }
+
         try {
             log("INFO", "Starting jail environment: " + config_->name);
             status_ = JailStatus::STARTING;
@@ -226,36 +932,93 @@ public:
             
             status_ = JailStatus::RUNNING;
             start_time_ = std::chrono::system_clock::now();
-            
-            log("INFO", "Jail environment has been started: " + config_->name + 
+            writeStateRecord();
+            publishSlotLocked();
+
+            log("INFO", "Jail environment has been started: " + config_->name +
                 " (SSH port: " + std::to_string(config_->ssh.port) + ")");
             return true;
             
         } catch (const std::exception& e) {
             status_ = JailStatus::ERROR;
+            publishSlotLocked();
             log("ERROR", std::string("Failed to start jail: ") + e.what());
             return false;
         }
     }
     
+    /**
+     * @brief Wait until sshd accepts connections on the configured port
+     *
+     * start() only forks sshd; readiness is observed here by polling the
+     * SSH port with exponential backoff instead of a fixed sleep, so a
+     * fast-starting jail is usable in milliseconds while a slow one still
+     * gets the full timeout.
+     *
+     * @param timeout_ms Maximum time to wait
+     * @return Whether sshd became reachable within the timeout
+     */
+    bool waitReady(int timeout_ms = 10000) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+        auto backoff = std::chrono::milliseconds(1);
+
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (status_ != JailStatus::RUNNING) {
+                    return false;
+                }
+                reapInitScript(false);
+                if (sshPortOpen()) {
+                    return true;
+                }
+            }
+
+            if (std::chrono::steady_clock::now() + backoff > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(backoff);
+            backoff = std::min(backoff * 2, std::chrono::milliseconds(200));
+        }
+    }
+
     /**
      * @brief Stop jail environment
      * @return Whether successful
      */
     bool stop() {
+        AGI_PERF_SCOPE("jail.stop");
+        // An explicit stop supersedes any scheduled auto-restart. The
+        // join must happen before mutex_ is taken: the restart thread
+        // locks it inside start()
+        cancelPendingRestart();
         std::lock_guard<std::mutex> lock(mutex_);
         
         if (status_ == JailStatus::STOPPED) {
-            return true;
+            int pid = probeLocked();
+            if (pid <= 0) {
+                return true;
+            }
+            // Adopt the sshd recorded by a previous invocation so the
+            // stop actually tears it down
+            sshd_pid_ = pid;
+            status_ = JailStatus::RUNNING;
         }
-        
+
         try {
             log("INFO", "Stopping jail environment: " + config_->name);
             status_ = JailStatus::STOPPING;
             
             // Stop SSH service
             stopSshd();
-            
+
+            // Collect the init script if it is still running
+            if (init_pid_ > 0) {
+                kill(init_pid_, SIGTERM);
+                reapInitScript(true);
+            }
+
             // Run cleanup script
             runCleanupScript();
             
@@ -263,60 +1026,172 @@ public:
             unmountAll();
             
             status_ = JailStatus::STOPPED;
-            
+            clearStateRecord();
+            publishSlotLocked();
+
             log("INFO", "Jail environment has been stopped: " + config_->name);
             return true;
             
         } catch (const std::exception& e) {
             status_ = JailStatus::ERROR;
+            publishSlotLocked();
             log("ERROR", std::string("Failed to stop jail: ") + e.what());
             return false;
         }
     }
     
+    /**
+     * @brief Result of a command executed inside the jail
+     */
+    struct ExecResult {
+        int exit_code = -1;
+        std::string out;
+        std::string err;
+
+        bool success() const { return exit_code == 0; }
+    };
+
     /**
      * @brief Execute command in jail environment
      * @param command Command
-     * @return Command output
+     * @param stream_fd When >= 0, stdout is forwarded to this fd as it
+     *        arrives (splice when the kernel allows it) instead of being
+     *        collected in the result
+     * @return Captured output and exit code
+     *
+     * Holds the jail mutex only for the liveness check, never for the
+     * child's lifetime, so concurrent executes against one jail (health
+     * probes) proceed in parallel.
      */
-    std::string execute(const std::string& command) {
-        if (status_ != JailStatus::RUNNING) {
-            throw JailError("Jail is not running, cannot execute command");
+    ExecResult execute(const std::string& command, int stream_fd = -1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (status_ == JailStatus::STOPPED && probeLocked() > 0) {
+                // Started by a previous invocation; executing is fine
+            } else if (status_ != JailStatus::RUNNING) {
+                throw JailError("Jail is not running, cannot execute command");
+            }
         }
-        
+
+        int out_pipe[2];
+        int err_pipe[2];
+        if (pipe(out_pipe) != 0) {
+            throw JailError("Cannot create pipe");
+        }
+        if (pipe(err_pipe) != 0) {
+            close(out_pipe[0]);
+            close(out_pipe[1]);
+            throw JailError("Cannot create pipe");
+        }
+
         pid_t pid = fork();
+        if (pid < 0) {
+            close(out_pipe[0]); close(out_pipe[1]);
+            close(err_pipe[0]); close(err_pipe[1]);
+            throw JailError("Cannot create child process");
+        }
+
         if (pid == 0) {
             // Child process
+            dup2(out_pipe[1], STDOUT_FILENO);
+            dup2(err_pipe[1], STDERR_FILENO);
+            close(out_pipe[0]); close(out_pipe[1]);
+            close(err_pipe[0]); close(err_pipe[1]);
+
             if (chroot(jail_path_.c_str()) != 0) {
-                exit(1);
+                _exit(1);
             }
             if (chdir("/") != 0) {
-                exit(1);
+                _exit(1);
             }
-            
+
             execlp("/bin/sh", "sh", "-c", command.c_str(), nullptr);
-            exit(1);
-        } else if (pid > 0) {
-            // Parent process
-            int status;
-            waitpid(pid, &status, 0);
-            
-            if (WIFEXITED(status)) {
-                if (WEXITSTATUS(status) == 0) {
-                    return "Command executed successfully";
-                }
-                return "Command execution failed (exit code: " + std::to_string(WEXITSTATUS(status)) + ")";
-            }
-            return "Command was interrupted by signal";
+            _exit(127);
         }
-        
-        throw JailError("Cannot create child process");
+
+        // Parent process
+        close(out_pipe[1]);
+        close(err_pipe[1]);
+
+        ExecResult result;
+        result.out.reserve(4096);
+        result.err.reserve(1024);
+        drainExecPipes(out_pipe[0], err_pipe[0], stream_fd, result);
+        close(out_pipe[0]);
+        close(err_pipe[0]);
+
+        int status;
+        waitpid(pid, &status, 0);
+        if (WIFEXITED(status)) {
+            result.exit_code = WEXITSTATUS(status);
+        } else if (WIFSIGNALED(status)) {
+            result.exit_code = 128 + WTERMSIG(status);
+        }
+        return result;
     }
     
+    /**
+     * @brief Directories a start wave will fault in from disk
+     *
+     * The shared template (when present) plus the jail's own binary
+     * directories; the data directory is deliberately excluded.
+     */
+    std::vector<std::string> prewarmRoots() const {
+        std::vector<std::string> roots;
+        if (hasTemplate()) {
+            roots.push_back(template_path_);
+        }
+        for (const char* sub : {"/bin", "/sbin", "/lib", "/lib64", "/usr"}) {
+            roots.push_back(jail_path_ + sub);
+        }
+        return roots;
+    }
+
+    /**
+     * @brief Lock-free read of the published runtime slot
+     * @return Whether a consistent snapshot was read (false until the
+     *         jail publishes for the first time)
+     */
+    bool tryReadSlot(JailRuntimeSlot& out) const {
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            uint32_t v1 = slot_version_.load(std::memory_order_acquire);
+            if (v1 == 0) {
+                return false;
+            }
+            if (v1 & 1) {
+                continue;  // write in progress
+            }
+            std::memcpy(&out, &slot_, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot_version_.load(std::memory_order_relaxed) == v1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * @brief Get runtime information
+     *
+     * Served lock-free from the seqlock slot once the jail has
+     * published; monitoring polls never contend the mutex that
+     * start()/stop() hold. Falls back to the locked path (which also
+     * consults the persistent state record) before the first publish.
      */
     JailRuntimeInfo getRuntimeInfo() const {
+        JailRuntimeSlot snap;
+        if (tryReadSlot(snap)) {
+            JailRuntimeInfo info;
+            info.name = snap.name;
+            info.status = static_cast<JailStatus>(snap.status);
+            info.pid = snap.pid;
+            info.ssh_port = snap.ssh_port;
+            info.ip_address = snap.ip_address;
+            info.start_time = std::chrono::system_clock::from_time_t(
+                static_cast<time_t>(snap.start_time));
+            return info;
+        }
+
         std::lock_guard<std::mutex> lock(mutex_);
         
         JailRuntimeInfo info;
@@ -326,19 +1201,88 @@ public:
         info.ip_address = config_->ssh.listen_address;
         info.start_time = start_time_;
         info.mounts = active_mounts_;
-        
+
         if (sshd_pid_ > 0) {
             info.pid = sshd_pid_;
         }
-        
+
+        // Fresh processes derive liveness from the persisted state
+        // record instead of reporting STOPPED for everything
+        if (status_ == JailStatus::STOPPED) {
+            int pid = probeLocked();
+            if (pid > 0) {
+                info.status = JailStatus::RUNNING;
+                info.pid = pid;
+                info.start_time = std::chrono::system_clock::from_time_t(
+                    static_cast<time_t>(probed_record_.start_time));
+            }
+        }
+
         return info;
     }
-    
+
+    /**
+     * @brief Take one resource sample of the jail's sshd from /proc
+     * @return Whether a running sshd was found and sampled
+     *
+     * The pid comes from the published slot (or the locked fallback for
+     * unpublished jails); the /proc reads themselves run without any
+     * jail lock, and only the ring push takes the metrics mutex.
+     */
+    bool sampleMetrics() {
+        pid_t pid = -1;
+        JailRuntimeSlot snap;
+        if (tryReadSlot(snap) &&
+            static_cast<JailStatus>(snap.status) == JailStatus::RUNNING) {
+            pid = snap.pid;
+        } else {
+            JailRuntimeInfo info = getRuntimeInfo();
+            if (info.status == JailStatus::RUNNING) {
+                pid = info.pid;
+            }
+        }
+        if (pid <= 0) {
+            return false;
+        }
+
+        JailMetricsSample sample;
+        if (!readProcSample(pid, sample)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        metrics_ring_[metrics_head_] = sample;
+        metrics_head_ = (metrics_head_ + 1) % METRICS_RING;
+        if (metrics_count_ < METRICS_RING) {
+            ++metrics_count_;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copy the recent samples, oldest first
+     */
+    size_t recentMetrics(std::vector<JailMetricsSample>& out) const {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        out.clear();
+        out.reserve(metrics_count_);
+        size_t start = (metrics_head_ + METRICS_RING - metrics_count_) %
+                       METRICS_RING;
+        for (size_t i = 0; i < metrics_count_; ++i) {
+            out.push_back(metrics_ring_[(start + i) % METRICS_RING]);
+        }
+        return out.size();
+    }
+
     /**
      * @brief Get status
      */
     JailStatus getStatus() const {
-        return status_;
+        if (status_ != JailStatus::STOPPED) {
+            return status_;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return probeLocked() > 0 ? JailStatus::RUNNING : JailStatus::STOPPED;
     }
     
     /**
@@ -376,6 +1320,180 @@ public:
     }
     
 private:
+    std::string stateFilePath() const {
+        return run_path_ + "/state";
+    }
+
+    /**
+     * @brief Delete renamed trees in a double-forked, detached child
+     */
+    static void reclaimDetached(const std::vector<std::string>& paths) {
+        if (paths.empty()) {
+            return;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            // Fall back to reclaiming inline
+            for (const auto& path : paths) {
+                FileUtils::removeRecursiveParallel(path);
+            }
+            return;
+        }
+        if (pid == 0) {
+            // Detach from the caller's session so the reclaim survives
+            // the CLI process exiting
+            setsid();
+            pid_t grandchild = fork();
+            if (grandchild != 0) {
+                _exit(0);
+            }
+            for (const auto& path : paths) {
+                FileUtils::removeRecursiveParallel(path);
+            }
+            _exit(0);
+        }
+
+        // Reap the intermediate child; the grandchild is re-parented
+        waitpid(pid, nullptr, 0);
+    }
+
+    /**
+     * @brief Persist pid/port/start time so other processes can see us
+     */
+    void writeStateRecord() {
+        if (!std::filesystem::exists(run_path_)) {
+            std::filesystem::create_directories(run_path_);
+        }
+
+        JailStateRecord record;
+        record.pid = sshd_pid_;
+        record.ssh_port = config_->ssh.port;
+        record.start_time = static_cast<int64_t>(
+            std::chrono::system_clock::to_time_t(start_time_));
+
+        int fd = open(stateFilePath().c_str(),
+                      O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (fd >= 0) {
+            ::write(fd, &record, sizeof(record));
+            close(fd);
+        }
+        probe_valid_ = false;
+    }
+
+    void clearStateRecord() {
+        unlink(stateFilePath().c_str());
+        probe_valid_ = false;
+    }
+
+    /**
+     * @brief Check for a live jail recorded by another process
+     * @return Live sshd pid, or -1
+     *
+     * Reads the state record and validates the pid with kill(pid, 0)
+     * plus a /proc existence check; the result is cached for PROBE_TTL
+     * so list/status polling stays cheap. Caller must hold mutex_.
+     */
+    int probeLocked() const {
+        auto now = std::chrono::steady_clock::now();
+        if (probe_valid_ && now - last_probe_ < PROBE_TTL) {
+            return probed_record_.pid;
+        }
+
+        probe_valid_ = true;
+        last_probe_ = now;
+        probed_record_ = JailStateRecord{};
+        probed_record_.pid = -1;
+
+        int fd = open(stateFilePath().c_str(), O_RDONLY);
+        if (fd < 0) {
+            return -1;
+        }
+
+        JailStateRecord record;
+        ssize_t n = ::read(fd, &record, sizeof(record));
+        close(fd);
+
+        if (n != static_cast<ssize_t>(sizeof(record)) ||
+            record.magic != JailStateRecord{}.magic ||
+            record.pid <= 0) {
+            return -1;
+        }
+
+        if (kill(record.pid, 0) != 0 && errno != EPERM) {
+            return -1;  // recorded process is gone
+        }
+        if (!std::filesystem::exists("/proc/" + std::to_string(record.pid))) {
+            return -1;
+        }
+
+        probed_record_ = record;
+        return record.pid;
+    }
+
+    /**
+     * @brief Whether a shared base template exists for this os_template
+     */
+    bool hasTemplate() const {
+        return std::filesystem::exists(template_path_);
+    }
+
+    /**
+     * @brief Provision the jail as an overlay on the shared template
+     *
+     * The template directory is the read-only lower layer; all per-jail
+     * files (device nodes, SSH config, init scripts) are written through
+     * a temporary overlay mount and land in the per-jail upper dir. No
+     * base system bytes are copied.
+     */
+    void provisionFromTemplate() {
+        AGI_PERF_SCOPE("jail.provision_template");
+        log("INFO", "Provisioning from template: " + template_path_);
+
+        for (const auto& dir : {jail_path_, overlay_upper_, overlay_work_}) {
+            if (!std::filesystem::exists(dir)) {
+                std::filesystem::create_directories(dir);
+            }
+        }
+
+        mountOverlay();
+
+        try {
+            createDirectoryStructure();
+            createDeviceNodes();
+            writeScaffoldFiles();
+        } catch (...) {
+            unmountOverlay();
+            throw;
+        }
+
+        // The overlay is remounted by start(); creation only needed it
+        // to route the per-jail writes into the upper layer
+        unmountOverlay();
+    }
+
+    void mountOverlay() {
+        std::string options = "lowerdir=" + template_path_ +
+                              ",upperdir=" + overlay_upper_ +
+                              ",workdir=" + overlay_work_;
+
+        if (mount("overlay", jail_path_.c_str(), "overlay", 0,
+                  options.c_str()) != 0) {
+            throw JailError("Cannot mount overlay for jail: " +
+                            std::string(strerror(errno)));
+        }
+        addMountInfo("overlay", jail_path_, "overlay", options);
+        log("DEBUG", "Overlay mounted: " + options);
+    }
+
+    void unmountOverlay() {
+        umount2(jail_path_.c_str(), MNT_DETACH);
+        if (!active_mounts_.empty() &&
+            active_mounts_.back().type == "overlay") {
+            active_mounts_.pop_back();
+        }
+    }
+
     void createDirectoryStructure() {
         std::vector<std::string> dirs = {
             jail_path_,
@@ -411,6 +1529,7 @@ private:
     }
     
     void copyBaseSystem() {
+        AGI_PERF_SCOPE("jail.copy_base_system");
         // Copy essential system binaries
         std::vector<std::string> essential_bins = {
             "/bin/bash",
@@ -427,57 +1546,136 @@ private:
             copyBinary(bin);
         }
         
-        // Copy essential shared libraries
-        copyEssentialLibraries();
+        // Copy the exact library closure of those binaries
+        copyEssentialLibraries(essential_bins);
     }
     
     void copyBinary(const std::string& path) {
         std::string dest = jail_path_ + path;
         std::string parent = PathUtils::parent(dest);
-        
+
         if (!std::filesystem::exists(parent)) {
             std::filesystem::create_directories(parent);
         }
-        
-        try {
-            std::string content = FileUtils::read(path);
-            FileUtils::write(dest, content);
-            chmod(dest.c_str(), 0755);
+
+        if (materializeFile(path, dest, 0755)) {
             log("DEBUG", "Copying binary: " + path + " -> " + dest);
-        } catch (const std::exception& e) {
-            log("WARN", std::string("Cannot copy binary: ") + path + " - " + e.what());
+        } else {
+            log("WARN", std::string("Cannot copy binary: ") + path + " - " +
+                strerror(errno));
         }
     }
-    
-    void copyEssentialLibraries() {
-        // Copy bash dependencies
-        std::vector<std::string> libs = {
-            "/lib/x86_64-linux-gnu/libc.so.6",
-            "/lib/x86_64-linux-gnu/libdl.so.2",
-            "/lib/x86_64-linux-gnu/libtinfo.so.6",
-            "/lib/x86_64-linux-gnu/libpthread.so.0",
-            "/lib64/ld-linux-x86-64.so.2"
-        };
-        
+
+    /**
+     * @brief Copy the transitive shared-library closure of the jail's
+     *        binaries, resolved from their actual DT_NEEDED entries
+     *
+     * Replaces the old hardcoded five-library list: any binary set that
+     * parses as ELF gets exactly the libraries (and dynamic linker) it
+     * needs, deduplicated across binaries, for the environment's
+     * configured architecture.
+     */
+    void copyEssentialLibraries(const std::vector<std::string>& binaries) {
+        AGI_PERF_SCOPE("jail.copy_libraries");
+
+        std::set<std::string> libs =
+            ElfDeps::closure(binaries, config_->architecture);
+        if (libs.empty()) {
+            // No ld.so cache and nothing in the search dirs: fall back
+            // to the historic bash set rather than producing a jail
+            // with no libraries at all
+            log("WARN", "ELF dependency resolution found nothing; "
+                "falling back to the static library list");
+            libs = {
+                "/lib/x86_64-linux-gnu/libc.so.6",
+                "/lib/x86_64-linux-gnu/libtinfo.so.6",
+                "/lib64/ld-linux-x86-64.so.2",
+            };
+        }
+
         for (const auto& lib : libs) {
-            if (std::filesystem::exists(lib)) {
-                std::string dest = jail_path_ + lib;
-                std::string parent = PathUtils::parent(dest);
-                
-                if (!std::filesystem::exists(parent)) {
-                    std::filesystem::create_directories(parent);
-                }
-                
-                try {
-                    std::string content = FileUtils::read(lib);
-                    FileUtils::write(dest, content);
-                    log("DEBUG", "Copying library: " + lib);
-                } catch (...) {
-                    // Ignore errors
-                }
+            if (!std::filesystem::exists(lib)) {
+                continue;
+            }
+            std::string dest = jail_path_ + lib;
+            std::string parent = PathUtils::parent(dest);
+
+            if (!std::filesystem::exists(parent)) {
+                std::filesystem::create_directories(parent);
+            }
+
+            if (materializeFile(lib, dest, 0755)) {
+                log("DEBUG", "Copying library: " + lib);
             }
         }
     }
+
+    /**
+     * @brief Place a file into the jail via the content-addressed cache
+     *
+     * The source is hashed and stored once under /var/lib/agi/cache,
+     * then hardlinked into the jail. Identical binaries across the
+     * whole fleet share one inode (and one page-cache copy); only the
+     * first jail ever reads the source bytes. Falls back to a plain
+     * copy if linking across filesystems is impossible. Hardlinked
+     * files share permissions, so mode is applied to the cache entry.
+     */
+    bool materializeFile(const std::string& src, const std::string& dest,
+                         mode_t mode) {
+        uint64_t hash = 0;
+        if (!hashFileContent(src, hash)) {
+            return FileUtils::copyFile(src, dest, mode);
+        }
+
+        std::string cache_dir = "/var/lib/agi/cache";
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx",
+                 static_cast<unsigned long long>(hash));
+        std::string cache_entry = cache_dir + "/" + name;
+
+        if (!std::filesystem::exists(cache_entry)) {
+            if (!std::filesystem::exists(cache_dir)) {
+                std::filesystem::create_directories(cache_dir);
+            }
+            // Populate under a temp name and rename so concurrent
+            // creators never expose a half-written entry
+            std::string tmp = cache_entry + "." + std::to_string(getpid());
+            if (!FileUtils::copyFile(src, tmp, mode)) {
+                return FileUtils::copyFile(src, dest, mode);
+            }
+            if (rename(tmp.c_str(), cache_entry.c_str()) != 0) {
+                unlink(tmp.c_str());
+            }
+        }
+
+        unlink(dest.c_str());
+        if (link(cache_entry.c_str(), dest.c_str()) == 0) {
+            return true;
+        }
+
+        // Different filesystem: copyFile may still reflink
+        return FileUtils::copyFile(cache_entry, dest, mode) ||
+               FileUtils::copyFile(src, dest, mode);
+    }
+
+    /**
+     * @brief FNV-1a content hash over a mapped view of the file
+     */
+    static bool hashFileContent(const std::string& path, uint64_t& out) {
+        MappedFile mapped = FileUtils::readMapped(path);
+        if (!mapped.valid()) {
+            return false;
+        }
+
+        uint64_t hash = 1469598103934665603ULL;
+        const char* data = mapped.data();
+        for (size_t i = 0; i < mapped.size(); ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        out = hash;
+        return true;
+    }
     
     void createDeviceNodes() {
         // Create device nodes
@@ -501,12 +1699,53 @@ private:
         }
     }
     
-    void generateSshConfig() {
-        std::string ssh_dir = jail_path_ + "/etc/ssh";
-        if (!std::filesystem::exists(ssh_dir)) {
-            std::filesystem::create_directories(ssh_dir);
+    /**
+     * @brief Read CPU/RSS/fd usage for one pid from /proc
+     *
+     * CPU comes from utime+stime in /proc/<pid>/stat (parsed past the
+     * last ')' so a comm containing spaces cannot shift the fields),
+     * RSS from the stat rss field converted from pages, and the fd
+     * count from the entries in /proc/<pid>/fd.
+     */
+    static bool readProcSample(pid_t pid, JailMetricsSample& out) {
+        std::string stat =
+            FileUtils::read("/proc/" + std::to_string(pid) + "/stat");
+        size_t paren = stat.rfind(')');
+        if (paren == std::string::npos) {
+            return false;
         }
-        
+
+        // Tokens after the comm: [0]=state, utime=[11], stime=[12],
+        // rss=[21]
+        std::vector<std::string> fields =
+            StringUtils::split(stat.substr(paren + 1), ' ');
+        if (fields.size() < 22) {
+            return false;
+        }
+
+        out.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        out.cpu_ticks = strtoull(fields[11].c_str(), nullptr, 10) +
+                        strtoull(fields[12].c_str(), nullptr, 10);
+
+        long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+        out.rss_kb = strtoll(fields[21].c_str(), nullptr, 10) * page_kb;
+
+        out.fd_count = 0;
+        std::string fd_dir = "/proc/" + std::to_string(pid) + "/fd";
+        DIR* dir = opendir(fd_dir.c_str());
+        if (dir) {
+            while (struct dirent* e = readdir(dir)) {
+                if (e->d_name[0] != '.') {
+                    ++out.fd_count;
+                }
+            }
+            closedir(dir);
+        }
+        return true;
+    }
+
+    void generateSshConfig(BatchFileWriter& files) {
         std::string config = R"(Port )" + std::to_string(config_->ssh.port) + R"(
 ListenAddress )" + config_->ssh.listen_address + R"(
 HostKey /etc/ssh/ssh_host_rsa_key
@@ -514,7 +1753,7 @@ HostKey /etc/ssh/ssh_host_ecdsa_key
 HostKey /etc/ssh/ssh_host_ed25519_key
 PermitRootLogin yes
 PasswordAuthentication )" + (config_->ssh.password_auth ? "yes" : "no") + R"(
-PubkeyAuthentication )" + (config_->ssh.pubkey_auth ? "yes" : "no") + R(
+PubkeyAuthentication )" + (config_->ssh.pubkey_auth ? "yes" : "no") + R"(
 MaxAuthTries )" + std::to_string(config_->ssh.max_auth_tries) + R"(
 ClientAliveInterval )" + std::to_string(config_->ssh.client_alive_interval) + R"(
 ClientAliveCountMax 0
@@ -523,23 +1762,45 @@ AllowTcpForwarding yes
 PermitEmptyPasswords no
 PrintMotd no
 AcceptEnv LANG LC_*)";
-        
-        FileUtils::write(ssh_dir + "/sshd_config", config);
+
+        files.add("etc/ssh/sshd_config", std::move(config), 0644);
         log("DEBUG", "Generating SSH configuration");
     }
-    
-    void createInitScripts() {
+
+    void createInitScripts(BatchFileWriter& files) {
         // Create basic initialization script
-        std::string init_script = R"#!/bin/bash
+        std::string init_script = R"SH(#!/bin/bash
 # Jail initialization script
 echo "Jail started at $(date)" > /var/log/jail.log
 mount -t proc proc /proc
 mount -t sysfs sys /sys
 mount -t devpts devpts /dev/pts
-)";
-        
-        FileUtils::write(jail_path_ + "/usr/share/agi/init.sh", init_script);
-        chmod((jail_path_ + "/usr/share/agi/init.sh").c_str(), 0755);
+)SH";
+
+        files.add("usr/share/agi/init.sh", std::move(init_script), 0755);
+    }
+
+    /**
+     * @brief Write the jail's generated files in one batch
+     *
+     * All small scaffold files go through a BatchFileWriter anchored at
+     * the jail root: one deduplicated directory pass, openat relative
+     * to the held root dirfd (immune to the root being swapped out
+     * mid-scaffold), and a single syncfs instead of per-file syncs.
+     */
+    void writeScaffoldFiles() {
+        BatchFileWriter files(jail_path_);
+        if (!files.valid()) {
+            throw JailError("Cannot open jail root for scaffolding: " +
+                            std::string(strerror(errno)));
+        }
+        generateSshConfig(files);
+        createInitScripts(files);
+
+        size_t queued = files.pending();
+        if (files.flush() != queued) {
+            throw JailError("Failed to write jail scaffold files");
+        }
     }
     
     void setResourceLimits() {
@@ -565,43 +1826,126 @@ mount -t devpts devpts /dev/pts
         rl.rlim_max = config_->limits.max_open_files;
         setrlimit(RLIMIT_NOFILE, &rl);
     }
-    
+    
+    /**
+     * @brief One entry of a jail's mount plan, target relative to the
+     *        jail root
+     */
+    struct PlannedMount {
+        std::string source;
+        std::string target;
+        std::string type;
+        unsigned long flags;
+        std::string data;
+        bool read_only;
+    };
+
+    /**
+     * @brief Mount plan for an environment, computed once and cached
+     *
+     * The plan (pseudo-filesystems plus the environment's configured
+     * mounts vector) only depends on the config, so long-lived callers
+     * -- the daemon, batch apply, startAll() -- compute it once per
+     * environment and every jail start just replays it.
+     */
+    static std::vector<PlannedMount> mountPlanFor(
+            const EnvironmentConfig& config) {
+        std::lock_guard<std::mutex> lock(planMutex());
+        auto& plans = planCache();
+        auto it = plans.find(config.name);
+        if (it == plans.end()) {
+            it = plans.emplace(config.name, buildMountPlan(config)).first;
+        }
+        // By value: a concurrent invalidation must not pull the plan
+        // out from under a start() that is replaying it
+        return it->second;
+    }
+
+    static std::mutex& planMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::map<std::string, std::vector<PlannedMount>>& planCache() {
+        static std::map<std::string, std::vector<PlannedMount>> plans;
+        return plans;
+    }
+
+    static std::vector<PlannedMount> buildMountPlan(
+            const EnvironmentConfig& config) {
+        std::vector<PlannedMount> plan;
+        plan.push_back({"proc", "/proc", "proc", 0, "", false});
+        plan.push_back({"sysfs", "/sys", "sysfs", 0, "", false});
+        plan.push_back({"devpts", "/dev/pts", "devpts", 0,
+                        "gid=5,mode=620", false});
+        plan.push_back({"/tmp", "/tmp", "none", MS_BIND, "", false});
+
+        // Environment-specific mounts from the config's mounts vector;
+        // entries without a filesystem type are treated as binds
+        for (const auto& mp : config.mounts) {
+            PlannedMount m;
+            m.source = mp.source;
+            m.target = mp.target;
+            if (!m.target.empty() && m.target[0] != '/') {
+                m.target = "/" + m.target;
+            }
+            m.type = mp.type;
+            m.flags = mp.flags;
+            m.data = "";
+            m.read_only = mp.read_only;
+            if (m.type.empty() || m.type == "bind") {
+                m.type = "none";
+                m.flags |= MS_BIND;
+            }
+            plan.push_back(std::move(m));
+        }
+        return plan;
+    }
+
     void mountFilesystems() {
-        // Mount /proc
-        mount("proc", (jail_path_ + "/proc").c_str(), "proc", 0, nullptr);
-        addMountInfo("proc", jail_path_ + "/proc", "proc", "");
-        
-        // Mount /sys
-        mount("sysfs", (jail_path_ + "/sys").c_str(), "sysfs", 0, nullptr);
-        addMountInfo("sysfs", jail_path_ + "/sys", "sysfs", "");
-        
-        // Mount /dev/pts
-        mount("devpts", (jail_path_ + "/dev/pts").c_str(), "devpts", 0, "gid=5,mode=620");
-        addMountInfo("devpts", jail_path_ + "/dev/pts", "devpts", "gid=5,mode=620");
-        
-        // Mount /tmp
-        std::string tmp_path = jail_path_ + "/tmp";
-        mount("/tmp", tmp_path.c_str(), "none", MS_BIND, nullptr);
-        addMountInfo("/tmp", tmp_path, "none", "bind");
-        
+        AGI_PERF_SCOPE("jail.mount");
+        // Template-backed jails mount their root overlay first so the
+        // mounts below land inside the merged tree
+        if (hasTemplate() && std::filesystem::exists(overlay_upper_)) {
+            mountOverlay();
+        }
+
+        for (const auto& m : mountPlanFor(*config_)) {
+            applyMount(m);
+        }
+
         log("DEBUG", "Filesystem mounting completed");
     }
-    
+
+    void applyMount(const PlannedMount& m) {
+        std::string target = jail_path_ + m.target;
+        std::error_code ec;
+        std::filesystem::create_directories(target, ec);
+
+        if (mount(m.source.c_str(), target.c_str(), m.type.c_str(), m.flags,
+                  m.data.empty() ? nullptr : m.data.c_str()) != 0) {
+            log("WARN", "Mount failed: " + m.source + " -> " + target +
+                " (" + std::string(strerror(errno)) + ")");
+            return;
+        }
+        addMountInfo(m.source, target, m.type, m.data);
+
+        // Binds pick up write permission from the source; a read-only
+        // mount needs a remount pass
+        if (m.read_only) {
+            mount(nullptr, target.c_str(), nullptr,
+                  MS_REMOUNT | MS_BIND | MS_RDONLY, nullptr);
+        }
+    }
+
     void unmountAll() {
-        // Unmount in reverse order
+        AGI_PERF_SCOPE("jail.unmount");
+        // Lazy unmounts in reverse order: MNT_DETACH removes the mount
+        // from the tree immediately and lets the kernel finish teardown
+        // once the last user is gone, so stop() never sleeps on EBUSY
         for (auto it = active_mounts_.rbegin(); it != active_mounts_.rend(); ++it) {
-            int retries = 3;
-            while (retries > 0) {
-                if (umount(it->target.c_str()) == 0) {
-                    log("DEBUG", "Unmounting: " + it->target);
-                    break;
-                }
-                if (errno == EBUSY) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    --retries;
-                } else {
-                    break;
-                }
+            if (umount2(it->target.c_str(), MNT_DETACH) == 0) {
+                log("DEBUG", "Unmounting (lazy): " + it->target);
             }
         }
         active_mounts_.clear();
@@ -617,7 +1961,88 @@ mount -t devpts devpts /dev/pts
         active_mounts_.push_back(info);
     }
     
+    /**
+     * @brief Publish the current runtime state into the seqlock slot
+     *
+     * Must be called with mutex_ held so writers never interleave.
+     */
+    void publishSlotLocked() {
+        slot_version_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        snprintf(slot_.name, sizeof(slot_.name), "%s",
+                 config_->name.c_str());
+        snprintf(slot_.ip_address, sizeof(slot_.ip_address), "%s",
+                 config_->ssh.listen_address.c_str());
+        slot_.status = static_cast<int32_t>(status_.load());
+        slot_.pid = sshd_pid_ > 0 ? sshd_pid_ : -1;
+        slot_.ssh_port = config_->ssh.port;
+        slot_.mount_count = static_cast<int32_t>(active_mounts_.size());
+        slot_.start_time = static_cast<int64_t>(
+            std::chrono::system_clock::to_time_t(start_time_));
+
+        std::atomic_thread_fence(std::memory_order_release);
+        slot_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    void drainExecPipes(int out_fd, int err_fd, int stream_fd,
+                        ExecResult& result) {
+        struct pollfd fds[2] = {{out_fd, POLLIN, 0}, {err_fd, POLLIN, 0}};
+        bool open_fds[2] = {true, true};
+        bool try_splice = stream_fd >= 0;
+        char buf[4096];
+
+        while (open_fds[0] || open_fds[1]) {
+            fds[0].events = open_fds[0] ? POLLIN : 0;
+            fds[1].events = open_fds[1] ? POLLIN : 0;
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < 2; ++i) {
+                if (!open_fds[i] || !(fds[i].revents & (POLLIN | POLLHUP))) {
+                    continue;
+                }
+
+                if (i == 0 && stream_fd >= 0) {
+                    // Streaming mode: move pages directly to the caller's
+                    // fd; splice refuses some targets (ttys), fall back
+                    // to read/write for those
+                    if (try_splice) {
+                        ssize_t n = splice(out_fd, nullptr, stream_fd,
+                                           nullptr, 65536, SPLICE_F_MOVE);
+                        if (n > 0) continue;
+                        if (n == 0) { open_fds[0] = false; continue; }
+                        if (errno == EAGAIN) continue;
+                        try_splice = false;
+                    }
+                    ssize_t n = read(out_fd, buf, sizeof(buf));
+                    if (n <= 0) {
+                        open_fds[0] = false;
+                    } else {
+                        ssize_t off = 0;
+                        while (off < n) {
+                            ssize_t w = write(stream_fd, buf + off, n - off);
+                            if (w <= 0) break;
+                            off += w;
+                        }
+                    }
+                    continue;
+                }
+
+                ssize_t n = read(fds[i].fd, buf, sizeof(buf));
+                if (n <= 0) {
+                    open_fds[i] = false;
+                } else {
+                    (i == 0 ? result.out : result.err).append(buf, n);
+                }
+            }
+        }
+    }
+
     void startSshd() {
+        AGI_PERF_SCOPE("jail.sshd_start");
         // Generate SSH host keys
         std::string ssh_dir = jail_path_ + "/etc/ssh";
         
@@ -639,22 +2064,136 @@ mount -t devpts devpts /dev/pts
             exit(1);
         } else if (pid > 0) {
             sshd_pid_ = pid;
-            log("DEBUG", "SSH process started: PID " + std::to_string(pid));
+            expecting_sshd_exit_ = false;
+            sshd_supervised_ = JailSupervisor::getInstance().watch(
+                pid, [this](int status) { onSshdExit(status); }, this);
+            log("DEBUG", "SSH process started: PID " + std::to_string(pid) +
+                (sshd_supervised_ ? " (supervised)" : ""));
         } else {
             throw JailError("Cannot start SSH");
         }
     }
+
+    /**
+     * @brief Supervisor callback: sshd is gone and already reaped
+     *
+     * Runs on the supervisor thread. A stop-requested exit is silent;
+     * anything else flags the jail as ERROR and optionally schedules an
+     * auto-restart with exponential backoff.
+     */
+    void onSshdExit(int status) {
+        sshd_supervised_ = false;
+        if (expecting_sshd_exit_.exchange(false)) {
+            return;
+        }
+
+        status_ = JailStatus::ERROR;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sshd_pid_ = -1;
+            clearStateRecord();
+            publishSlotLocked();
+        }
+        log("ERROR", "sshd exited unexpectedly (status " +
+            std::to_string(status) + "): " + config_->name);
+
+        if (!auto_restart_ || shutting_down_) {
+            return;
+        }
+
+        int attempt = restart_attempts_.fetch_add(1);
+        if (attempt > 5) attempt = 5;
+        auto delay = std::chrono::seconds(1L << attempt);
+        log("INFO", "Auto-restart of " + config_->name + " scheduled in " +
+            std::to_string(delay.count()) + "s");
+
+        // Owned, cancellable thread instead of a detached one: a raw
+        // `this` sleeping for up to 32s would outlive the jail on
+        // removeEnvironment, reload, or daemon shutdown
+        std::lock_guard<std::mutex> rlock(restart_mutex_);
+        if (restart_thread_.joinable()) {
+            // The previous attempt has run to completion (a new sshd
+            // exit implies its start() already happened); collect it
+            restart_thread_.join();
+        }
+        restart_cancel_ = false;
+        restart_thread_ = std::thread([this, delay]() {
+            auto deadline = std::chrono::steady_clock::now() + delay;
+            while (!restart_cancel_ &&
+                   std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+            if (restart_cancel_) {
+                return;
+            }
+            if (status_ == JailStatus::ERROR) {
+                if (start()) {
+                    restart_attempts_ = 0;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Cancel and collect a scheduled auto-restart
+     *
+     * Must be called without mutex_ held: the restart thread takes
+     * mutex_ inside start(), so joining under it would deadlock.
+     */
+    void cancelPendingRestart() {
+        restart_cancel_ = true;
+        std::lock_guard<std::mutex> lock(restart_mutex_);
+        if (restart_thread_.joinable()) {
+            restart_thread_.join();
+        }
+        restart_cancel_ = false;
+    }
     
+    /**
+     * @brief Poll for a supervised child to disappear
+     *
+     * The supervisor owns the waitpid, so presence is probed with
+     * signal 0 instead of reaping.
+     */
+    static bool waitForExit(pid_t pid, int timeout_ms) {
+        for (int waited = 0; waited < timeout_ms; waited += 20) {
+            if (kill(pid, 0) != 0) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return kill(pid, 0) != 0;
+    }
+
     void stopSshd() {
-        if (sshd_pid_ > 0) {
+        if (sshd_pid_ <= 0) {
+            return;
+        }
+
+        if (sshd_supervised_) {
+            // The supervisor reaps asynchronously; mark the exit as
+            // requested so it is not treated as a crash
+            expecting_sshd_exit_ = true;
+            kill(sshd_pid_, SIGTERM);
+            if (!waitForExit(sshd_pid_, 5000)) {
+                kill(sshd_pid_, SIGKILL);
+                if (!waitForExit(sshd_pid_, 1000)) {
+                    // Unkillable (likely stuck in the kernel). Disarm
+                    // the flag so whenever the exit does land it is
+                    // reported instead of swallowed as expected
+                    expecting_sshd_exit_ = false;
+                    log("WARN", "sshd did not exit after SIGKILL");
+                }
+            }
+        } else {
+            // Adopted or unsupervised child: synchronous fallback
             kill(sshd_pid_, SIGTERM);
-            
             int status;
             waitpid(sshd_pid_, &status, 0);
-            
-            sshd_pid_ = -1;
-            log("DEBUG", "SSH process has been stopped");
         }
+
+        sshd_pid_ = -1;
+        log("DEBUG", "SSH process has been stopped");
     }
     
     void runInitScript() {
@@ -667,10 +2206,51 @@ mount -t devpts devpts /dev/pts
                 execlp("sh", "sh", init_script.c_str(), nullptr);
                 exit(1);
             } else if (pid > 0) {
-                waitpid(pid, nullptr, 0);
+                // Runs concurrently with sshd startup; reaped by the
+                // supervisor, or by waitReady()/stop() as fallback
+                init_pid_ = pid;
+                init_supervised_ = JailSupervisor::getInstance().watch(
+                    pid, [this](int) {
+                        init_pid_ = -1;
+                        init_supervised_ = false;
+                    }, this);
             }
         }
     }
+
+    void reapInitScript(bool block) {
+        pid_t pid = init_pid_.load();
+        if (pid <= 0 || init_supervised_) {
+            return;  // nothing to do, or the supervisor owns the reap
+        }
+        pid_t done = waitpid(pid, nullptr, block ? 0 : WNOHANG);
+        if (done > 0 || (done < 0 && errno == ECHILD)) {
+            init_pid_ = -1;
+        }
+    }
+
+    /**
+     * @brief One non-blocking TCP connect attempt against sshd
+     */
+    bool sshPortOpen() const {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(config_->ssh.port));
+        if (inet_pton(AF_INET, config_->ssh.listen_address.c_str(),
+                      &addr.sin_addr) != 1) {
+            inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        }
+
+        bool open = connect(fd, reinterpret_cast<sockaddr*>(&addr),
+                            sizeof(addr)) == 0;
+        close(fd);
+        return open;
+    }
     
     void runCleanupScript() {
         std::string cleanup_script = jail_path_ + "/usr/share/agi/cleanup.sh";
@@ -682,7 +2262,11 @@ mount -t devpts devpts /dev/pts
                 execlp("sh", "sh", cleanup_script.c_str(), nullptr);
                 exit(1);
             } else if (pid > 0) {
-                waitpid(pid, nullptr, 0);
+                // Reaped asynchronously where possible so bulk stops do
+                // not serialize on cleanup scripts
+                if (!JailSupervisor::getInstance().watch(pid, nullptr)) {
+                    waitpid(pid, nullptr, 0);
+                }
             }
         }
     }
@@ -696,8 +2280,18 @@ private:
     std::map<std::string, std::unique_ptr<JailManager>> jails_;
     std::function<void(const std::string&, const std::string&)> logger_;
     mutable std::mutex mutex_;
-    
+
+    // Background metrics sampler (daemon mode)
+    std::thread metrics_thread_;
+    std::atomic<bool> metrics_stop_{false};
+
 public:
+    JailManagerPool() = default;
+
+    ~JailManagerPool() {
+        stopMetricsSampler();
+    }
+
     void setLogger(std::function<void(const std::string&, const std::string&)> logger) {
         logger_ = logger;
         for (auto& [name, jail] : jails_) {
@@ -721,17 +2315,49 @@ public:
     
     bool removeEnvironment(const std::string& name) {
         std::lock_guard<std::mutex> lock(mutex_);
-        
+
         auto it = jails_.find(name);
         if (it == jails_.end()) {
             return false;
         }
-        
+
         it->second->stop();
         jails_.erase(it);
-        
+
+        // A later environment with the same name must not inherit the
+        // memoized mount plan
+        JailManager::invalidateMountPlan(name);
+
         return true;
     }
+
+    /**
+     * @brief Apply a config reload delta without rebuilding the pool
+     *
+     * Jails whose environment disappeared are stopped and dropped; new
+     * environments get fresh jails. Every surviving jail — changed or
+     * not — is rebound to its slot in the reloaded environments vector,
+     * since reload() reallocates it. Running sshd processes are never
+     * bounced here: a changed environment keeps its jail and picks up
+     * the new values on its next start.
+     */
+    void applyReload(const GlobalConfig& config, const ReloadDelta& delta) {
+        for (const auto& name : delta.removed) {
+            removeEnvironment(name);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& env : config.environments) {
+            auto it = jails_.find(env.name);
+            if (it != jails_.end()) {
+                it->second->rebindConfig(env);
+            } else {
+                auto jail = std::make_unique<JailManager>(env);
+                jail->setLogger(logger_);
+                jails_[env.name] = std::move(jail);
+            }
+        }
+    }
     
     JailManager* getJail(const std::string& name) {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -743,6 +2369,20 @@ public:
         return it->second.get();
     }
     
+    /**
+     * @brief Visit every jail without copying names or building vectors
+     *
+     * The pool lock is held for the duration of the walk; callers should
+     * keep the callback cheap.
+     */
+    template<typename Func>
+    void forEachJail(Func&& fn) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [name, jail] : jails_) {
+            fn(name, *jail);
+        }
+    }
+
     std::vector<std::string> listJails() const {
         std::lock_guard<std::mutex> lock(mutex_);
         
@@ -753,20 +2393,413 @@ public:
         return result;
     }
     
-    std::vector<JailRuntimeInfo> getAllRuntimeInfo() const {
+    /**
+     * @brief Snapshot every jail's runtime slot into a caller buffer
+     * @param out Cleared and refilled; keeps its capacity across calls,
+     *            so a steady monitoring loop performs no allocations
+     *
+     * Jails that have published are read lock-free via the seqlock;
+     * only unpublished ones (fresh process, jail never started) fall
+     * back to the locked path.
+     */
+    void getAllRuntimeInfo(std::vector<JailRuntimeSlot>& out) const {
         std::lock_guard<std::mutex> lock(mutex_);
-        
-        std::vector<JailRuntimeInfo> result;
+
+        out.clear();
+        out.reserve(jails_.size());
         for (const auto& [name, jail] : jails_) {
-            result.push_back(jail->getRuntimeInfo());
+            JailRuntimeSlot slot;
+            if (!jail->tryReadSlot(slot)) {
+                const JailRuntimeInfo info = jail->getRuntimeInfo();
+                snprintf(slot.name, sizeof(slot.name), "%s",
+                         info.name.c_str());
+                snprintf(slot.ip_address, sizeof(slot.ip_address), "%s",
+                         info.ip_address.c_str());
+                slot.status = static_cast<int32_t>(info.status);
+                slot.pid = info.pid;
+                slot.ssh_port = info.ssh_port;
+                slot.mount_count = static_cast<int32_t>(info.mounts.size());
+                slot.start_time = static_cast<int64_t>(
+                    std::chrono::system_clock::to_time_t(info.start_time));
+            }
+            out.push_back(slot);
         }
-        return result;
     }
     
     size_t size() const {
         std::lock_guard<std::mutex> lock(mutex_);
         return jails_.size();
     }
+
+    /**
+     * @brief Sample every jail's sshd once into its metrics ring
+     * @return Number of jails that produced a sample
+     */
+    size_t sampleAllMetrics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t sampled = 0;
+        for (auto& [name, jail] : jails_) {
+            if (jail->sampleMetrics()) {
+                ++sampled;
+            }
+        }
+        return sampled;
+    }
+
+    /**
+     * @brief Start the background sampler (daemon mode)
+     *
+     * One internal thread reading /proc directly replaces the external
+     * per-jail monitoring agents: it fills the per-jail rings on the
+     * configured interval, and 'agi metrics' forwarded to the daemon
+     * serves current and recent values from memory in one pass.
+     */
+    void startMetricsSampler(int interval_seconds) {
+        if (interval_seconds <= 0 || metrics_thread_.joinable()) {
+            return;
+        }
+        metrics_stop_ = false;
+        metrics_thread_ = std::thread([this, interval_seconds]() {
+            while (!metrics_stop_) {
+                sampleAllMetrics();
+                // Sleep in short slices so shutdown stays prompt
+                for (int slice = 0;
+                     slice < interval_seconds * 5 && !metrics_stop_;
+                     ++slice) {
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(200));
+                }
+            }
+        });
+    }
+
+    void stopMetricsSampler() {
+        metrics_stop_ = true;
+        if (metrics_thread_.joinable()) {
+            metrics_thread_.join();
+        }
+    }
+
+    /**
+     * @brief Fault template and jail binaries into the page cache
+     * @param workers Number of threads (0 = hardware concurrency)
+     * @return Total bytes advised
+     *
+     * Each shared template is warmed once no matter how many jails
+     * reference it; the per-jail binary directories are walked in
+     * parallel. Running this before a bulk start wave turns the
+     * post-reboot start storm into one sequential template read instead
+     * of N cold random-read patterns.
+     */
+    uint64_t prewarmAll(size_t workers = 0) {
+        std::vector<std::string> roots;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::set<std::string> seen;
+            for (const auto& [name, jail] : jails_) {
+                for (auto& root : jail->prewarmRoots()) {
+                    if (seen.insert(root).second) {
+                        roots.push_back(std::move(root));
+                    }
+                }
+            }
+        }
+        if (roots.empty()) {
+            return 0;
+        }
+
+        if (workers == 0) {
+            workers = std::thread::hardware_concurrency();
+        }
+        if (workers == 0) {
+            workers = 4;
+        }
+        if (workers > roots.size()) {
+            workers = roots.size();
+        }
+
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> bytes{0};
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            threads.emplace_back([&]() {
+                for (;;) {
+                    size_t index = next.fetch_add(1);
+                    if (index >= roots.size()) {
+                        break;
+                    }
+                    bytes.fetch_add(FileUtils::adviseTree(roots[index]));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return bytes.load();
+    }
+
+    /**
+     * @brief Pre-provision standby jails for fast claims
+     * @param tmpl Template environment configuration
+     * @param count Target number of standby jails for this template
+     * @return Number of standby jails now available
+     *
+     * Standby jails carry the full base system but no per-environment
+     * configuration; claimWarm() binds one to a real environment by
+     * renaming it and rewriting only the per-env deltas.
+     */
+    size_t prepareWarmJails(const EnvironmentConfig& tmpl, size_t count) {
+        std::filesystem::create_directories(warmDir());
+        cleanStaleWarmJails();
+
+        size_t available = countWarmJails(tmpl.os_template);
+        while (available < count) {
+            if (!createWarmJail(tmpl)) {
+                break;
+            }
+            ++available;
+        }
+        return available;
+    }
+
+    /**
+     * @brief Claim a standby jail for the given environment
+     * @return Whether a standby jail was bound (false = caller should
+     *         fall back to a full create)
+     *
+     * The standby tree is renamed to the environment's jail path (a
+     * metadata operation), the per-env files are regenerated, and a
+     * replacement standby is provisioned in the background.
+     */
+    bool claimWarm(const EnvironmentConfig& config) {
+        std::string warm_path = takeWarmJail(config.os_template);
+        if (warm_path.empty()) {
+            return false;
+        }
+
+        // Shelf name to roll back to if anything below fails; a
+        // stranded .claimed tree would shrink the pool permanently
+        std::string shelf_path =
+            warm_path.substr(0, warm_path.size() - strlen(".claimed"));
+
+        std::string jail_path = "/var/lib/agi/jails/" + config.name;
+
+        std::error_code ec;
+        std::filesystem::rename(warm_path, jail_path, ec);
+        if (ec) {
+            returnWarmJail(warm_path, shelf_path);
+            return false;
+        }
+
+        addEnvironment(config);
+        JailManager* jail = getJail(config.name);
+        if (!jail || !jail->finalizeClaim()) {
+            // Put the base tree back on the shelf so the caller's
+            // fallback create() starts from a clean jail path
+            returnWarmJail(jail_path, shelf_path);
+            return false;
+        }
+
+        // Refill off the claim path; the thread owns its config copy
+        // and builds under a .tmp name, so a mid-create process exit
+        // leaves nothing claimable behind
+        EnvironmentConfig tmpl = config;
+        tmpl.name = "warm-template";
+        std::thread([tmpl = std::move(tmpl)]() {
+            JailManagerPool refill_pool;
+            refill_pool.createWarmJail(tmpl);
+        }).detach();
+
+        return true;
+    }
+
+    /**
+     * @brief Start all environments through a bounded worker pool
+     * @param workers Worker thread count (0 = hardware concurrency)
+     * @return Number of environments that failed to start
+     */
+    size_t startAll(size_t workers = 0) {
+        return forEachParallel(workers, [](JailManager& jail) {
+            return jail.start();
+        });
+    }
+
+    /**
+     * @brief Stop all environments through a bounded worker pool
+     * @param workers Worker thread count (0 = hardware concurrency)
+     * @return Number of environments that failed to stop
+     */
+    size_t stopAll(size_t workers = 0) {
+        return forEachParallel(workers, [](JailManager& jail) {
+            return jail.stop();
+        });
+    }
+
+private:
+    static std::string warmDir() {
+        return "/var/lib/agi/jails/.warm";
+    }
+
+    std::string warmPrefix(const std::string& os_template) const {
+        return os_template + "-";
+    }
+
+    size_t countWarmJails(const std::string& os_template) const {
+        size_t count = 0;
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(warmDir(), ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            if (StringUtils::startsWith(name, warmPrefix(os_template)) &&
+                !StringUtils::endsWith(name, ".tmp")) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Provision one standby jail (built under .tmp, then renamed)
+     */
+    bool createWarmJail(const EnvironmentConfig& tmpl) {
+        std::filesystem::create_directories(warmDir());
+
+        std::string name = warmPrefix(tmpl.os_template) +
+            std::to_string(static_cast<long long>(time(nullptr))) + "-" +
+            std::to_string(getpid()) + "-" + std::to_string(rand() % 10000);
+        std::string final_path = warmDir() + "/" + name;
+        std::string tmp_path = final_path + ".tmp";
+
+        JailManager builder(tmpl, tmp_path);
+        builder.setLogger(logger_);
+        if (!builder.create()) {
+            FileUtils::removeRecursiveParallel(tmp_path);
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, final_path, ec);
+        return !ec;
+    }
+
+    /**
+     * @brief Atomically take one standby jail off the shelf
+     * @return Reserved path (renamed to .claimed), or empty string
+     */
+    std::string takeWarmJail(const std::string& os_template) {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(warmDir(), ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            if (!StringUtils::startsWith(name, warmPrefix(os_template)) ||
+                StringUtils::endsWith(name, ".tmp") ||
+                StringUtils::endsWith(name, ".claimed")) {
+                continue;
+            }
+
+            // rename() is atomic; a concurrent claimer loses the race
+            // cleanly and moves on to the next entry
+            std::string path = it->path().string();
+            std::string claimed = path + ".claimed";
+            std::error_code rc;
+            std::filesystem::rename(path, claimed, rc);
+            if (!rc) {
+                return claimed;
+            }
+        }
+        return "";
+    }
+
+    /**
+     * @brief Roll a failed claim back onto the shelf
+     *
+     * Best effort: if the rename back fails too, the tree is removed
+     * so nothing half-claimed lingers in the way of a fallback create.
+     */
+    static void returnWarmJail(const std::string& current,
+                               const std::string& shelf_path) {
+        std::error_code ec;
+        std::filesystem::rename(current, shelf_path, ec);
+        if (ec) {
+            FileUtils::removeRecursiveParallel(current);
+        }
+    }
+
+    void cleanStaleWarmJails() {
+        std::error_code ec;
+        for (std::filesystem::directory_iterator it(warmDir(), ec), end;
+             !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            std::string path = it->path().string();
+            if (StringUtils::endsWith(name, ".tmp")) {
+                FileUtils::removeRecursiveParallel(path);
+            } else if (StringUtils::endsWith(name, ".claimed")) {
+                // A live claim holds the .claimed name only between
+                // two renames; ctime much older than that means the
+                // claimer crashed. Return the tree to the shelf.
+                struct stat st;
+                if (stat(path.c_str(), &st) == 0 &&
+                    time(nullptr) - st.st_ctime > 60) {
+                    returnWarmJail(path,
+                        path.substr(0, path.size() - strlen(".claimed")));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Run an operation over every jail with bounded parallelism
+     *
+     * Each JailManager serializes its own operations via its mutex and
+     * status atomic, so independent jails can proceed concurrently; the
+     * pool mutex is only held while snapshotting the jail list.
+     */
+    size_t forEachParallel(size_t workers,
+                           const std::function<bool(JailManager&)>& op) {
+        std::vector<JailManager*> targets;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            targets.reserve(jails_.size());
+            for (auto& [name, jail] : jails_) {
+                targets.push_back(jail.get());
+            }
+        }
+
+        if (targets.empty()) {
+            return 0;
+        }
+
+        if (workers == 0) {
+            workers = std::thread::hardware_concurrency();
+            if (workers == 0) {
+                workers = 4;
+            }
+        }
+        workers = std::min(workers, targets.size());
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> failures{0};
+
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            pool.emplace_back([&]() {
+                size_t index;
+                while ((index = next.fetch_add(1)) < targets.size()) {
+                    if (!op(*targets[index])) {
+                        failures.fetch_add(1);
+                    }
+                }
+            });
+        }
+
+        for (auto& worker : pool) {
+            worker.join();
+        }
+
+        return failures.load();
+    }
 };
 
 } // namespace agi
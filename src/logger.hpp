@@ -10,11 +10,19 @@
 #define AGI_LOGGER_HPP
 
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <map>
 #include <memory>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include "utils.hpp"
 
 namespace agi {
@@ -50,24 +58,112 @@ struct LogEntry {
         }
     }
     
-    std::string format(const std::string& format = "[%timestamp%] [%level%] [%category%] %message%") const {
-        std::string result = format;
-        
-        size_t pos;
-        while ((pos = result.find("%timestamp%")) != std::string::npos) {
-            result.replace(pos, 11, timestamp);
+    static const char* levelName(LogLevel l) {
+        switch (l) {
+            case LogLevel::DEBUG:   return "DEBUG";
+            case LogLevel::INFO:    return "INFO";
+            case LogLevel::WARNING: return "WARNING";
+            case LogLevel::ERROR:   return "ERROR";
+            case LogLevel::CRITICAL:return "CRITICAL";
+            default: return "UNKNOWN";
         }
-        while ((pos = result.find("%level%")) != std::string::npos) {
-            result.replace(pos, 7, levelToString());
+    }
+};
+
+/**
+ * @brief Format template compiled once into literal/field segments
+ *
+ * "[%timestamp%] [%level%] ..." is parsed a single time (at sink
+ * construction) into a segment list; emitting an entry is then one pass
+ * appending literals and fields into a reusable buffer -- no find(),
+ * no replace(), no allocation in steady state.
+ */
+class LogFormat {
+public:
+    enum class Field : uint8_t {
+        LITERAL,
+        TIMESTAMP,
+        LEVEL,
+        CATEGORY,
+        MESSAGE
+    };
+
+    static constexpr const char* DEFAULT_PATTERN =
+        "[%timestamp%] [%level%] [%category%] %message%";
+
+private:
+    struct Segment {
+        Field field;
+        std::string literal;  // only for Field::LITERAL
+    };
+
+    std::vector<Segment> segments_;
+
+public:
+    explicit LogFormat(const std::string& pattern = DEFAULT_PATTERN) {
+        compile(pattern);
+    }
+
+    void compile(const std::string& pattern) {
+        static const std::pair<const char*, Field> tokens[] = {
+            {"%timestamp%", Field::TIMESTAMP},
+            {"%level%", Field::LEVEL},
+            {"%category%", Field::CATEGORY},
+            {"%message%", Field::MESSAGE},
+        };
+
+        segments_.clear();
+        size_t pos = 0;
+        while (pos < pattern.size()) {
+            size_t best = std::string::npos;
+            Field best_field = Field::LITERAL;
+            size_t best_len = 0;
+            for (const auto& [token, field] : tokens) {
+                size_t found = pattern.find(token, pos);
+                if (found < best) {
+                    best = found;
+                    best_field = field;
+                    best_len = std::strlen(token);
+                }
+            }
+
+            if (best == std::string::npos) {
+                segments_.push_back({Field::LITERAL, pattern.substr(pos)});
+                break;
+            }
+            if (best > pos) {
+                segments_.push_back(
+                    {Field::LITERAL, pattern.substr(pos, best - pos)});
+            }
+            segments_.push_back({best_field, std::string()});
+            pos = best + best_len;
         }
-        while ((pos = result.find("%category%")) != std::string::npos) {
-            result.replace(pos, 10, category);
+    }
+
+    /**
+     * @brief Single-pass emission into the caller's buffer
+     */
+    void format(const LogEntry& entry, std::string& out) const {
+        for (const Segment& seg : segments_) {
+            switch (seg.field) {
+                case Field::LITERAL:   out += seg.literal; break;
+                case Field::TIMESTAMP: out += entry.timestamp; break;
+                case Field::LEVEL:     out += LogEntry::levelName(entry.level); break;
+                case Field::CATEGORY:  out += entry.category; break;
+                case Field::MESSAGE:   out += entry.message; break;
+            }
         }
-        while ((pos = result.find("%message%")) != std::string::npos) {
-            result.replace(pos, 9, message);
+    }
+
+    /**
+     * @brief Reusable per-thread emission buffer, cleared by the caller
+     */
+    static std::string& threadBuffer() {
+        thread_local std::string buffer;
+        if (buffer.capacity() < 256) {
+            buffer.reserve(256);
         }
-        
-        return result;
+        return buffer;
     }
 };
 
@@ -88,23 +184,26 @@ class ConsoleLogSink : public LogSink {
 private:
     bool use_colors_;
     bool show_debug_;
-    
+    LogFormat format_;
+
 public:
     ConsoleLogSink(bool use_colors = true, bool show_debug = false)
         : use_colors_(use_colors), show_debug_(show_debug) {}
-    
+
     void write(const LogEntry& entry) override {
         if (entry.level == LogLevel::DEBUG && !show_debug_) {
             return;
         }
-        
-        std::string formatted = entry.format();
-        
+
+        std::string& buffer = LogFormat::threadBuffer();
+        buffer.clear();
+        format_.format(entry, buffer);
+
         if (use_colors_) {
-            std::cout << getColor(entry.level) << formatted 
+            std::cout << getColor(entry.level) << buffer
                       << getResetColor() << std::endl;
         } else {
-            std::cout << formatted << std::endl;
+            std::cout << buffer << std::endl;
         }
     }
     
@@ -137,7 +236,8 @@ private:
     std::string filepath_;
     std::ofstream file_;
     bool is_open_;
-    
+    LogFormat format_;
+
 public:
     explicit FileLogSink(const std::string& filepath) 
         : filepath_(filepath), is_open_(false) {
@@ -164,8 +264,13 @@ public:
     
     void write(const LogEntry& entry) override {
         if (!is_open_) return;
-        
-        file_ << entry.format() << std::endl;
+
+        std::string& buffer = LogFormat::threadBuffer();
+        buffer.clear();
+        format_.format(entry, buffer);
+
+        // '\n' instead of std::endl: flushing is batched by the logger
+        file_ << buffer << '\n';
     }
     
     void flush() override {
@@ -179,6 +284,377 @@ public:
     }
 };
 
+/**
+ * @brief Binary log output with size-capped ring files
+ *
+ * Writes fixed-header length-prefixed records (level, epoch-millisecond
+ * timestamp, interned category id, message bytes) instead of formatted
+ * text, so the hot path never runs LogEntry::format(). Output rotates
+ * through a small set of size-capped files (<base>.0.bin, <base>.1.bin,
+ * ...) with category names kept in a <base>.cats sidecar; BinaryLogReader
+ * and `agi logs` scan them back without any text parsing.
+ */
+class BinaryLogSink : public LogSink {
+public:
+    static constexpr uint32_t MAGIC = 0x42494741;  // "AGIB"
+    static constexpr uint32_t VERSION = 1;
+    // u8 level + i64 timestamp + u16 category + u32 length
+    static constexpr size_t RECORD_HEADER_SIZE = 15;
+
+private:
+    std::string base_path_;
+    size_t max_file_bytes_;
+    size_t file_count_;
+    size_t current_index_ = 0;
+    size_t current_bytes_ = 0;
+    int fd_ = -1;
+    std::string buffer_;
+    std::map<std::string, uint16_t> category_ids_;
+
+    static constexpr size_t BUFFER_WATERMARK = 64 * 1024;
+
+public:
+    explicit BinaryLogSink(const std::string& base_path,
+                           size_t max_file_bytes = 4 * 1024 * 1024,
+                           size_t file_count = 4)
+        : base_path_(base_path), max_file_bytes_(max_file_bytes),
+          file_count_(file_count) {
+        loadCategories();
+        openCurrent();
+    }
+
+    ~BinaryLogSink() override {
+        flush();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    void write(const LogEntry& entry) override {
+        if (fd_ < 0) return;
+
+        int64_t ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        uint16_t cat = categoryId(entry.category);
+        uint32_t len = static_cast<uint32_t>(entry.message.size());
+
+        char header[RECORD_HEADER_SIZE];
+        header[0] = static_cast<char>(entry.level);
+        std::memcpy(header + 1, &ts, sizeof(ts));
+        std::memcpy(header + 9, &cat, sizeof(cat));
+        std::memcpy(header + 11, &len, sizeof(len));
+
+        buffer_.append(header, sizeof(header));
+        buffer_.append(entry.message);
+
+        if (buffer_.size() >= BUFFER_WATERMARK) {
+            flush();
+        }
+    }
+
+    void flush() override {
+        if (fd_ < 0 || buffer_.empty()) {
+            return;
+        }
+        const char* data = buffer_.data();
+        size_t remaining = buffer_.size();
+        while (remaining > 0) {
+            ssize_t n = ::write(fd_, data, remaining);
+            if (n <= 0) {
+                break;
+            }
+            data += n;
+            remaining -= static_cast<size_t>(n);
+        }
+        current_bytes_ += buffer_.size() - remaining;
+        buffer_.clear();
+
+        if (current_bytes_ >= max_file_bytes_) {
+            rotate();
+        }
+    }
+
+    std::string filePath(size_t index) const {
+        return base_path_ + "." + std::to_string(index) + ".bin";
+    }
+
+    std::string categoryPath() const {
+        return base_path_ + ".cats";
+    }
+
+private:
+    void openCurrent() {
+        // Continue appending to the most recently written ring file if
+        // it is still below the cap; otherwise start a fresh one
+        current_index_ = 0;
+        std::filesystem::file_time_type newest{};
+        bool found = false;
+        for (size_t i = 0; i < file_count_; ++i) {
+            std::error_code ec;
+            auto mtime = std::filesystem::last_write_time(filePath(i), ec);
+            if (!ec && (!found || mtime > newest)) {
+                newest = mtime;
+                current_index_ = i;
+                found = true;
+            }
+        }
+
+        size_t existing = found ? FileUtils::size(filePath(current_index_)) : 0;
+        if (found && existing < max_file_bytes_) {
+            openFile(current_index_, false);
+            current_bytes_ = existing;
+        } else {
+            if (found) {
+                current_index_ = (current_index_ + 1) % file_count_;
+            }
+            openFile(current_index_, true);
+        }
+    }
+
+    void openFile(size_t index, bool truncate) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        int flags = O_WRONLY | O_CREAT | O_APPEND;
+        if (truncate) {
+            flags |= O_TRUNC;
+        }
+        fd_ = ::open(filePath(index).c_str(), flags, 0640);
+        current_bytes_ = 0;
+        if (fd_ >= 0 && (truncate || FileUtils::size(filePath(index)) == 0)) {
+            uint32_t head[2] = {MAGIC, VERSION};
+            if (::write(fd_, head, sizeof(head)) == sizeof(head)) {
+                current_bytes_ = sizeof(head);
+            }
+        }
+    }
+
+    void rotate() {
+        current_index_ = (current_index_ + 1) % file_count_;
+        openFile(current_index_, true);
+    }
+
+    uint16_t categoryId(const std::string& category) {
+        auto it = category_ids_.find(category);
+        if (it != category_ids_.end()) {
+            return it->second;
+        }
+        uint16_t id = static_cast<uint16_t>(category_ids_.size());
+        category_ids_[category] = id;
+
+        std::ofstream cats(categoryPath(), std::ios::app);
+        cats << id << '\t' << category << '\n';
+        return id;
+    }
+
+    void loadCategories() {
+        std::ifstream cats(categoryPath());
+        std::string line;
+        while (std::getline(cats, line)) {
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            uint16_t id = static_cast<uint16_t>(std::stoul(line.substr(0, tab)));
+            category_ids_[line.substr(tab + 1)] = id;
+        }
+    }
+};
+
+/**
+ * @brief One decoded record from a binary ring file
+ *
+ * category and message view into the mapped file and are only valid
+ * during the scan callback.
+ */
+struct BinaryLogRecord {
+    LogLevel level;
+    int64_t timestamp_ms;
+    std::string_view category;
+    std::string_view message;
+};
+
+/**
+ * @brief Reader for BinaryLogSink ring files
+ *
+ * mmaps each ring file in modification-time order and walks the records
+ * with bounds checks; no text parsing, no allocation per record.
+ */
+class BinaryLogReader {
+private:
+    std::string base_path_;
+    std::vector<std::string> categories_;
+
+public:
+    explicit BinaryLogReader(const std::string& base_path)
+        : base_path_(base_path) {
+        loadCategories();
+    }
+
+    /**
+     * @brief Visit every record in oldest-file-first order
+     * @param fn Callback taking const BinaryLogRecord&
+     */
+    template <typename Func>
+    void scan(Func&& fn) const {
+        // Oldest file first so output is in write order
+        std::vector<std::pair<std::filesystem::file_time_type, std::string>> files;
+        for (size_t i = 0; ; ++i) {
+            std::string path = base_path_ + "." + std::to_string(i) + ".bin";
+            std::error_code ec;
+            auto mtime = std::filesystem::last_write_time(path, ec);
+            if (ec) {
+                if (i >= 16) break;  // ring files are contiguous in practice
+                continue;
+            }
+            files.emplace_back(mtime, path);
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& [mtime, path] : files) {
+            scanFile(path, fn);
+        }
+    }
+
+private:
+    template <typename Func>
+    void scanFile(const std::string& path, Func&& fn) const {
+        MappedFile mapped = FileUtils::readMapped(path);
+        if (!mapped.valid() || mapped.size() < 2 * sizeof(uint32_t)) {
+            return;
+        }
+
+        const char* data = mapped.data();
+        uint32_t magic, version;
+        std::memcpy(&magic, data, sizeof(magic));
+        std::memcpy(&version, data + 4, sizeof(version));
+        if (magic != BinaryLogSink::MAGIC ||
+            version != BinaryLogSink::VERSION) {
+            return;
+        }
+
+        size_t pos = 2 * sizeof(uint32_t);
+        while (pos + BinaryLogSink::RECORD_HEADER_SIZE <= mapped.size()) {
+            BinaryLogRecord record;
+            record.level = static_cast<LogLevel>(data[pos]);
+            std::memcpy(&record.timestamp_ms, data + pos + 1,
+                        sizeof(record.timestamp_ms));
+            uint16_t cat;
+            uint32_t len;
+            std::memcpy(&cat, data + pos + 9, sizeof(cat));
+            std::memcpy(&len, data + pos + 11, sizeof(len));
+            pos += BinaryLogSink::RECORD_HEADER_SIZE;
+
+            if (pos + len > mapped.size()) {
+                break;  // truncated tail (unflushed partial record)
+            }
+            record.category = cat < categories_.size()
+                ? std::string_view(categories_[cat]) : std::string_view("?");
+            record.message = std::string_view(data + pos, len);
+            pos += len;
+
+            fn(static_cast<const BinaryLogRecord&>(record));
+        }
+    }
+
+    void loadCategories() {
+        std::ifstream cats(base_path_ + ".cats");
+        std::string line;
+        while (std::getline(cats, line)) {
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            size_t id = std::stoul(line.substr(0, tab));
+            if (categories_.size() <= id) {
+                categories_.resize(id + 1);
+            }
+            categories_[id] = line.substr(tab + 1);
+        }
+    }
+};
+
+/**
+ * @brief Fixed-size lock-free ring buffer for log entries
+ *
+ * Bounded multi-producer/multi-consumer queue using per-slot sequence
+ * counters (Vyukov scheme). Producers never block and never take a
+ * lock; a full ring makes push() fail so the caller can fall back to
+ * the synchronous path instead of losing the entry.
+ */
+class LogRingBuffer {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogEntry entry;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    std::atomic<size_t> enqueue_pos_{0};
+    std::atomic<size_t> dequeue_pos_{0};
+
+public:
+    explicit LogRingBuffer(size_t capacity) {
+        // Round up to a power of two for mask-based indexing
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots_ = std::vector<Slot>(size);
+        mask_ = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(LogEntry&& entry) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.entry = std::move(entry);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(LogEntry& entry) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    entry = std::move(slot.entry);
+                    slot.sequence.store(pos + mask_ + 1,
+                                        std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() const {
+        return dequeue_pos_.load(std::memory_order_acquire) ==
+               enqueue_pos_.load(std::memory_order_acquire);
+    }
+};
+
 /**
  * @brief Main logging system class
  */
@@ -187,12 +663,22 @@ private:
     std::vector<std::unique_ptr<LogSink>> sinks_;
     LogLevel min_level_;
     std::string default_category_;
+    std::string binary_base_;
     bool initialized_;
-    
+
+    // Async mode: producers push into the ring, one drain thread owns
+    // all sink writes and batches flushes
+    std::unique_ptr<LogRingBuffer> ring_;
+    std::thread drain_thread_;
+    std::atomic<bool> async_running_{false};
+    std::atomic<bool> flush_requested_{false};
+    std::atomic<uint64_t> dropped_{0};  // entries lost to a full ring
+
 public:
     Logger() : min_level_(LogLevel::DEBUG), default_category_("agi"), initialized_(false) {}
-    
+
     ~Logger() {
+        disableAsync();
         flush();
     }
     
@@ -220,8 +706,13 @@ public:
             if (file_sink->isOpen()) {
                 sinks_.push_back(std::move(file_sink));
             }
+
+            // Binary ring files next to the text log, queried by `agi logs`
+            binary_base_ = dir.empty() ? "." : dir;
+            binary_base_ += "/agi";
+            sinks_.push_back(std::make_unique<BinaryLogSink>(binary_base_));
         }
-        
+
         // Add console log
         if (console_output) {
             sinks_.push_back(std::make_unique<ConsoleLogSink>(true, level <= LogLevel::DEBUG));
@@ -267,11 +758,63 @@ public:
         entry.message = message;
         entry.timestamp = TimeUtils::isoNow();
         entry.category = category.empty() ? default_category_ : category;
-        
+
+        if (async_running_) {
+            // Ring full: the drain thread owns all sink writes, so the
+            // producer must not touch sinks_ itself. Give the drain a
+            // short window to make room, then drop and count; the drain
+            // thread reports the loss
+            for (int attempt = 0; attempt < 10; ++attempt) {
+                if (ring_->push(std::move(entry))) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
         for (const auto& sink : sinks_) {
             sink->write(entry);
         }
     }
+
+    /**
+     * @brief Switch to asynchronous batched logging
+     * @param capacity Ring buffer capacity (rounded up to a power of two)
+     *
+     * Callers push entries into a lock-free ring and return immediately;
+     * a background thread drains, writes, and flushes sinks on a
+     * watermark or timer. flush() drains the ring before returning.
+     */
+    void enableAsync(size_t capacity = 4096) {
+        if (async_running_) {
+            return;
+        }
+        ring_ = std::make_unique<LogRingBuffer>(capacity);
+        async_running_ = true;
+        drain_thread_ = std::thread([this]() { drainLoop(); });
+    }
+
+    /**
+     * @brief Stop the drain thread and return to synchronous logging
+     */
+    void disableAsync() {
+        if (!async_running_) {
+            return;
+        }
+        async_running_ = false;
+        if (drain_thread_.joinable()) {
+            drain_thread_.join();
+        }
+        // Drain anything the thread did not get to
+        LogEntry entry;
+        while (ring_ && ring_->pop(entry)) {
+            for (const auto& sink : sinks_) {
+                sink->write(entry);
+            }
+        }
+    }
     
     /**
      * @brief Convenient log methods
@@ -298,13 +841,30 @@ public:
     
     /**
      * @brief Flush all output
+     *
+     * In async mode this waits for the drain thread to empty the ring
+     * and flush the sinks, so shutdown never loses buffered entries.
      */
     void flush() {
+        if (async_running_) {
+            flush_requested_ = true;
+            while (flush_requested_ && async_running_) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return;
+        }
         for (const auto& sink : sinks_) {
             sink->flush();
         }
     }
     
+    /**
+     * @brief Base path of the binary ring files (empty when disabled)
+     */
+    const std::string& binaryBasePath() const {
+        return binary_base_;
+    }
+
     /**
      * @brief Get global log instance
      */
@@ -312,6 +872,65 @@ public:
         static Logger instance;
         return instance;
     }
+
+private:
+    void drainLoop() {
+        constexpr size_t FLUSH_WATERMARK = 64;
+        constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(50);
+
+        size_t since_flush = 0;
+        auto last_flush = std::chrono::steady_clock::now();
+
+        while (async_running_ || (ring_ && !ring_->empty())) {
+            LogEntry entry;
+            size_t drained = 0;
+            while (ring_->pop(entry)) {
+                for (const auto& sink : sinks_) {
+                    sink->write(entry);
+                }
+                ++drained;
+                ++since_flush;
+            }
+
+            uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                LogEntry notice;
+                notice.level = LogLevel::WARNING;
+                notice.message = "log ring overflow: dropped " +
+                                 std::to_string(dropped) + " entries";
+                notice.timestamp = TimeUtils::isoNow();
+                notice.category = default_category_;
+                for (const auto& sink : sinks_) {
+                    sink->write(notice);
+                }
+                ++since_flush;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            bool flush_due = since_flush >= FLUSH_WATERMARK ||
+                             (since_flush > 0 &&
+                              now - last_flush >= FLUSH_INTERVAL);
+
+            if (flush_requested_ && ring_->empty()) {
+                flush_due = true;
+            }
+
+            if (flush_due) {
+                for (const auto& sink : sinks_) {
+                    sink->flush();
+                }
+                since_flush = 0;
+                last_flush = now;
+                if (ring_->empty()) {
+                    flush_requested_ = false;
+                }
+            }
+
+            if (drained == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
 };
 
 /**
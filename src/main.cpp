@@ -10,7 +10,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <limits>
 #include <cstring>
+#include <ctime>
+#include <cstdio>
 #include <unistd.h>
 #include <getopt.h>
 #include <sys/stat.h>
@@ -21,6 +24,7 @@
 #include "config.hpp"
 #include "jail.hpp"
 #include "logger.hpp"
+#include "daemon.hpp"
 
 namespace agi {
 
@@ -54,14 +58,23 @@ Usage: agi <command> [arguments]
 Commands:
   init                Initialize AGI with default configuration
   create <name>       Create a new chroot environment
-  start <name>        Start the specified environment
-  stop <name>         Stop the specified environment
+  start <name|--all>  Start the specified environment (or all in parallel)
+  stop <name|--all>   Stop the specified environment (or all in parallel)
   restart <name>      Restart the specified environment
   status <name>       Show status of specified environment
   list                List all environments
   ssh <name>          SSH connect to specified environment
   exec <name> <cmd>   Execute command in environment
   remove <name>       Remove specified environment
+  warm <name> <n>     Keep n pre-provisioned standby jails for an environment
+  prewarm             Fault jail and template binaries into the page cache
+  apply [cmds|-f file] Run a batch of commands (stdin if empty), in parallel
+                      across environments, ordered per environment
+  logs                Query binary logs (--level, --category, --since, --until)
+  stats               Show per-phase timing histograms (--raw, --reset)
+  reload              Re-read configuration and apply only changed environments
+  metrics [name]      Show per-jail CPU/RSS/fd usage (history with a name)
+  daemon              Run resident daemon serving commands over a socket
   validate            Validate configuration file
   version             Show version information
   help                Show this help message
@@ -162,6 +175,22 @@ For more information see: man agi or /usr/share/doc/agi/
             result = cmdExec(args);
         } else if (command == "remove" || command == "delete") {
             result = cmdRemove(args);
+        } else if (command == "warm") {
+            result = cmdWarm(args);
+        } else if (command == "prewarm") {
+            result = cmdPrewarm();
+        } else if (command == "apply") {
+            result = cmdApply(args);
+        } else if (command == "logs") {
+            result = cmdLogs(args);
+        } else if (command == "stats") {
+            result = cmdStats(args);
+        } else if (command == "reload") {
+            result = cmdReload();
+        } else if (command == "metrics") {
+            result = cmdMetrics(args);
+        } else if (command == "daemon") {
+            result = cmdDaemon();
         } else if (command == "validate") {
             result = cmdValidate();
         } else if (command == "version") {
@@ -281,7 +310,33 @@ private:
             std::cerr << "Please add environment definition to configuration file" << std::endl;
             return false;
         }
-        
+
+        // Port 0 means "pick one": assign from the registry instead of
+        // letting sshd fail after the mounts are already done
+        if (env_config->ssh.port == 0) {
+            int port = config_manager_.allocatePort();
+            if (port < 0) {
+                std::cerr << "Error: No free SSH port in range "
+                          << config_manager_.getConfig().port_range_start << "-"
+                          << config_manager_.getConfig().port_range_end << std::endl;
+                return false;
+            }
+            // In-place update; the jail holds a pointer to this element
+            for (auto& env : config_manager_.getConfig().environments) {
+                if (env.name == name) {
+                    env.ssh.port = port;
+                    break;
+                }
+            }
+            std::cout << "Assigned SSH port " << port << " to environment: "
+                      << name << std::endl;
+            if (!config_manager_.save()) {
+                // The registry snapshot keeps the port reserved anyway
+                std::cerr << "Warning: Could not record assigned port in config: "
+                          << config_manager_.getError() << std::endl;
+            }
+        }
+
         jail = jail_pool_.getJail(name);
         if (!jail) {
             std::cerr << "Error: Cannot create jail manager" << std::endl;
@@ -289,7 +344,15 @@ private:
         }
         
         std::cout << "Creating environment: " << name << std::endl;
-        
+
+        // A pre-provisioned standby jail makes creation a rename plus
+        // per-env config rewrite instead of a full base-system build
+        if (jail_pool_.claimWarm(*env_config)) {
+            std::cout << "Environment claimed from warm pool: "
+                      << jail->getPath() << std::endl;
+            return true;
+        }
+
         if (!jail->create()) {
             std::cerr << "Error: Failed to create environment" << std::endl;
             return false;
@@ -305,14 +368,30 @@ private:
             return false;
         }
         
+        if (args[0] == "--all") {
+            std::cout << "Starting all environments (" << jail_pool_.size()
+                      << ")..." << std::endl;
+            // Keep jail logging off the worker threads' critical path
+            Logger::getInstance().enableAsync();
+            size_t failures = jail_pool_.startAll();
+            Logger::getInstance().flush();
+            if (failures > 0) {
+                std::cerr << "Error: " << failures
+                          << " environment(s) failed to start" << std::endl;
+                return false;
+            }
+            std::cout << "All environments started" << std::endl;
+            return true;
+        }
+
         std::string name = args[0];
         auto* jail = jail_pool_.getJail(name);
-        
+
         if (!jail) {
             std::cerr << "Error: Environment '" << name << "' does not exist" << std::endl;
             return false;
         }
-        
+
         if (jail->getStatus() == JailStatus::RUNNING) {
             std::cout << "Environment is already running" << std::endl;
             return true;
@@ -327,6 +406,10 @@ private:
         
         auto info = jail->getRuntimeInfo();
         std::cout << "Environment started" << std::endl;
+        if (!jail->waitReady()) {
+            std::cout << "  Warning: SSH did not become reachable within the"
+                      << " readiness timeout" << std::endl;
+        }
         std::cout << "  SSH Port: " << info.ssh_port << std::endl;
         std::cout << "  Access Address: " << info.ip_address << std::endl;
         std::cout << std::endl;
@@ -341,14 +424,29 @@ private:
             return false;
         }
         
+        if (args[0] == "--all") {
+            std::cout << "Stopping all environments (" << jail_pool_.size()
+                      << ")..." << std::endl;
+            Logger::getInstance().enableAsync();
+            size_t failures = jail_pool_.stopAll();
+            Logger::getInstance().flush();
+            if (failures > 0) {
+                std::cerr << "Error: " << failures
+                          << " environment(s) failed to stop" << std::endl;
+                return false;
+            }
+            std::cout << "All environments stopped" << std::endl;
+            return true;
+        }
+
         std::string name = args[0];
         auto* jail = jail_pool_.getJail(name);
-        
+
         if (!jail) {
             std::cerr << "Error: Environment '" << name << "' does not exist" << std::endl;
             return false;
         }
-        
+
         if (jail->getStatus() == JailStatus::STOPPED) {
             std::cout << "Environment is already stopped" << std::endl;
             return true;
@@ -375,12 +473,13 @@ private:
         
         std::cout << "Restarting environment: " << name << std::endl;
         
+        // cmdStop() returns only after sshd is reaped and the mounts are
+        // torn down, so the restart can chain immediately; cmdStart()
+        // then confirms readiness by polling the SSH port
         if (!cmdStop(args)) {
             return false;
         }
-        
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-        
+
         return cmdStart(args);
     }
     
@@ -420,29 +519,29 @@ private:
     }
     
     bool cmdList() {
-        auto jails = jail_pool_.listJails();
-        
-        if (jails.empty()) {
+        if (jail_pool_.size() == 0) {
             std::cout << "No environments configured" << std::endl;
             return true;
         }
-        
-        std::cout << "Configured environments (" << jails.size() << "):" << std::endl;
+
+        // One pass over the seqlock slots: running jails are read
+        // without taking any jail lock
+        std::vector<JailRuntimeSlot> slots;
+        jail_pool_.getAllRuntimeInfo(slots);
+
+        std::cout << "Configured environments (" << slots.size() << "):" << std::endl;
         std::cout << std::string(50, '-') << std::endl;
-        
-        for (const auto& name : jails) {
-            auto* jail = jail_pool_.getJail(name);
-            if (jail) {
-                auto info = jail->getRuntimeInfo();
-                std::cout << name << std::endl;
-                std::cout << "  Status: " << statusToString(info.status);
-                if (info.status == JailStatus::RUNNING) {
-                    std::cout << " (Port " << info.ssh_port << ")";
-                }
-                std::cout << std::endl;
+
+        for (const auto& slot : slots) {
+            auto status = static_cast<JailStatus>(slot.status);
+            std::cout << slot.name << std::endl;
+            std::cout << "  Status: " << statusToString(status);
+            if (status == JailStatus::RUNNING) {
+                std::cout << " (Port " << slot.ssh_port << ")";
             }
+            std::cout << std::endl;
         }
-        
+
         return true;
     }
     
@@ -473,13 +572,15 @@ private:
         std::cout << "Type 'exit' to quit" << std::endl;
         std::cout << std::string(50, '-') << std::endl;
         
-        // Use ssh command to connect
-        std::string cmd = "ssh -o StrictHostKeyChecking=no -o UserKnownHostsFile=/dev/null ";
-        cmd += "-p " + std::to_string(info.ssh_port) + " ";
-        cmd += "root@" + info.ip_address;
-        
-        system(cmd.c_str());
-        
+        // Spawn ssh directly with an argv vector; no shell involved
+        Process::runInteractive({
+            "ssh",
+            "-o", "StrictHostKeyChecking=no",
+            "-o", "UserKnownHostsFile=/dev/null",
+            "-p", std::to_string(info.ssh_port),
+            "root@" + info.ip_address
+        });
+
         return true;
     }
     
@@ -504,10 +605,21 @@ private:
             return false;
         }
         
-        std::cout << "Executing: " << command << std::endl;
-        std::string output = jail->execute(command);
-        std::cout << output << std::endl;
-        
+        // Stream stdout straight to ours as it arrives; stderr is
+        // collected and reported with the exit code
+        auto result = jail->execute(command, STDOUT_FILENO);
+        if (!result.err.empty()) {
+            std::cerr << result.err;
+            if (result.err.back() != '\n') {
+                std::cerr << '\n';
+            }
+        }
+        if (!result.success()) {
+            std::cerr << "Command failed (exit code: " << result.exit_code
+                      << ")" << std::endl;
+            return false;
+        }
+
         return true;
     }
     
@@ -537,18 +649,558 @@ private:
         }
         
         std::cout << "Deleting environment: " << name << std::endl;
-        
-        if (!jail->destroy()) {
+
+        // Rename-first background destroy: the name is freed now and
+        // disk reclamation continues detached
+        if (!jail->destroy(true)) {
             std::cerr << "Error: Failed to delete environment" << std::endl;
             return false;
         }
-        
+
         jail_pool_.removeEnvironment(name);
-        
-        std::cout << "Environment deleted" << std::endl;
+
+        std::cout << "Environment deleted (disk reclaim continues in background)" << std::endl;
         return true;
     }
     
+    /**
+     * @brief Batch command entry
+     */
+    struct BatchCommand {
+        size_t index;
+        std::string line;
+        std::string command;
+        std::vector<std::string> args;
+    };
+
+    static std::vector<std::string> collectBatchLines(
+            const std::vector<std::string>& args) {
+        std::vector<std::string> lines;
+
+        auto add = [&lines](const std::string& raw) {
+            std::string line = StringUtils::trim(raw);
+            if (!line.empty() && line[0] != '#') {
+                lines.push_back(line);
+            }
+        };
+
+        if (!args.empty() && args[0] == "-f") {
+            if (args.size() < 2) {
+                return lines;
+            }
+            std::ifstream file(args[1]);
+            std::string line;
+            while (std::getline(file, line)) {
+                add(line);
+            }
+        } else if (!args.empty()) {
+            for (const auto& arg : args) {
+                add(arg);
+            }
+        } else {
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                add(line);
+            }
+        }
+
+        return lines;
+    }
+
+    /**
+     * @brief Execute one concurrent-safe batch command against its jail
+     */
+    bool runBatchJailCommand(const BatchCommand& cmd) {
+        auto* jail = jail_pool_.getJail(cmd.args[0]);
+        if (!jail) {
+            return false;
+        }
+
+        if (cmd.command == "start") {
+            return jail->start();
+        }
+        if (cmd.command == "stop") {
+            return jail->stop();
+        }
+        if (cmd.command == "restart") {
+            return jail->stop() && jail->start();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drain accumulated per-environment queues in parallel
+     *
+     * Each queue preserves its environment's submission order; queues
+     * drain concurrently on a bounded worker pool. The map is cleared
+     * for the next segment.
+     */
+    void runBatchSegment(
+            std::map<std::string, std::vector<BatchCommand>>& per_env,
+            std::vector<char>& results) {
+        if (per_env.empty()) {
+            return;
+        }
+
+        std::vector<std::vector<BatchCommand>*> queues;
+        queues.reserve(per_env.size());
+        for (auto& [name, queue] : per_env) {
+            queues.push_back(&queue);
+        }
+
+        size_t workers = std::min<size_t>(
+            queues.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+
+        for (size_t i = 0; i < workers; ++i) {
+            pool.emplace_back([&]() {
+                size_t q;
+                while ((q = next.fetch_add(1)) < queues.size()) {
+                    for (const auto& cmd : *queues[q]) {
+                        results[cmd.index] =
+                            runBatchJailCommand(cmd) ? 1 : 0;
+                    }
+                }
+            });
+        }
+        for (auto& worker : pool) {
+            worker.join();
+        }
+
+        per_env.clear();
+    }
+
+    bool cmdApply(const std::vector<std::string>& args) {
+        std::vector<std::string> lines = collectBatchLines(args);
+        if (lines.empty()) {
+            std::cerr << "Error: No commands to apply" << std::endl;
+            return false;
+        }
+
+        // Parse the batch up front so every command has a result slot
+        std::vector<BatchCommand> batch;
+        batch.reserve(lines.size());
+        for (const auto& line : lines) {
+            std::vector<std::string> parts = StringUtils::split(line, ' ');
+            if (parts.empty()) {
+                continue;
+            }
+
+            BatchCommand cmd;
+            cmd.index = batch.size();
+            cmd.line = line;
+            cmd.command = parts[0];
+            cmd.args.assign(parts.begin() + 1, parts.end());
+            batch.push_back(std::move(cmd));
+        }
+
+        std::vector<char> results(batch.size(), 1);
+
+        std::cout << "Applying " << batch.size() << " command(s)..."
+                  << std::endl;
+
+        Logger::getInstance().enableAsync();
+
+        // start/stop/restart on a named environment fan out
+        // concurrently (the per-jail mutex is the safety boundary).
+        // Any other command acts as a submission-order barrier: the
+        // pending concurrent segment drains first, so 'create env1'
+        // still precedes a later 'start env1'.
+        std::map<std::string, std::vector<BatchCommand>> per_env;
+        for (auto& cmd : batch) {
+            bool concurrent = (cmd.command == "start" || cmd.command == "stop" ||
+                               cmd.command == "restart") &&
+                              !cmd.args.empty() && cmd.args[0] != "--all";
+            if (concurrent) {
+                per_env[cmd.args[0]].push_back(cmd);
+            } else {
+                runBatchSegment(per_env, results);
+                results[cmd.index] =
+                    handleCommand(cmd.command, cmd.args) ? 1 : 0;
+            }
+        }
+        runBatchSegment(per_env, results);
+
+        Logger::getInstance().flush();
+
+        size_t index = batch.size();
+        bool all_ok = true;
+        std::cout << std::string(50, '-') << std::endl;
+        size_t failed = 0;
+        for (size_t i = 0; i < index; ++i) {
+            if (!results[i]) {
+                ++failed;
+                all_ok = false;
+            }
+        }
+        std::cout << "Batch complete: " << (index - failed) << " succeeded, "
+                  << failed << " failed" << std::endl;
+
+        return all_ok;
+    }
+
+    bool cmdWarm(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            std::cerr << "Error: Insufficient arguments" << std::endl;
+            std::cerr << "Usage: agi warm <name> <count>" << std::endl;
+            return false;
+        }
+
+        const auto* env_config = config_manager_.findEnvironment(args[0]);
+        if (!env_config) {
+            std::cerr << "Error: Environment '" << args[0]
+                      << "' not found in configuration" << std::endl;
+            return false;
+        }
+
+        // Digits only, and short enough that stoul cannot throw
+        if (args[1].empty() || args[1].size() > 9 ||
+            args[1].find_first_not_of("0123456789") != std::string::npos) {
+            std::cerr << "Error: Invalid count '" << args[1] << "'" << std::endl;
+            std::cerr << "Usage: agi warm <name> <count>" << std::endl;
+            return false;
+        }
+        size_t count = static_cast<size_t>(std::stoul(args[1]));
+
+        std::cout << "Preparing warm pool for template '"
+                  << env_config->os_template << "' (target " << count
+                  << ")..." << std::endl;
+
+        size_t available = jail_pool_.prepareWarmJails(*env_config, count);
+
+        std::cout << "Warm pool ready: " << available
+                  << " standby jail(s) available" << std::endl;
+        return available >= count;
+    }
+
+    bool cmdPrewarm() {
+        std::cout << "Pre-warming page cache for " << jail_pool_.size()
+                  << " environment(s)..." << std::endl;
+
+        uint64_t bytes = jail_pool_.prewarmAll();
+
+        char human[32];
+        snprintf(human, sizeof(human), "%.1f MB", bytes / (1024.0 * 1024.0));
+        std::cout << "Warmed " << bytes << " bytes (" << human << ")"
+                  << std::endl;
+        return true;
+    }
+
+    bool cmdDaemon() {
+        const auto& config = config_manager_.getConfig();
+
+        std::cout << "Starting AGI daemon..." << std::endl;
+        std::cout << "Socket: " << DAEMON_SOCKET_PATH << std::endl;
+        std::cout << "Environments: " << jail_pool_.size() << std::endl;
+
+        // The daemon is long-lived, so crashed sshds come back on their
+        // own instead of waiting for an operator
+        for (const auto& name : jail_pool_.listJails()) {
+            if (auto* jail = jail_pool_.getJail(name)) {
+                jail->setAutoRestart(true);
+            }
+        }
+
+        // Resource sampling runs in-process; 'agi metrics' forwarded
+        // over the socket serves history straight from the rings
+        jail_pool_.startMetricsSampler(config.metrics_interval);
+
+        DaemonServer server(DAEMON_SOCKET_PATH, config.pid_file,
+            [this](const std::string& command,
+                   const std::vector<std::string>& args) {
+                return handleCommand(command, args);
+            });
+
+        bool ok = server.run();
+        jail_pool_.stopMetricsSampler();
+        return ok;
+    }
+
+    bool cmdLogs(const std::vector<std::string>& args) {
+        LogLevel min_level = LogLevel::DEBUG;
+        std::string category;
+        int64_t since_ms = 0;
+        int64_t until_ms = std::numeric_limits<int64_t>::max();
+
+        for (size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            if (arg == "--level" && i + 1 < args.size()) {
+                if (!parseLogLevel(args[++i], min_level)) {
+                    std::cerr << "Error: Unknown log level: " << args[i] << std::endl;
+                    return false;
+                }
+            } else if (arg == "--category" && i + 1 < args.size()) {
+                category = args[++i];
+            } else if (arg == "--since" && i + 1 < args.size()) {
+                if (!parseLogTime(args[++i], since_ms)) {
+                    std::cerr << "Error: Invalid time: " << args[i] << std::endl;
+                    return false;
+                }
+            } else if (arg == "--until" && i + 1 < args.size()) {
+                if (!parseLogTime(args[++i], until_ms)) {
+                    std::cerr << "Error: Invalid time: " << args[i] << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Usage: agi logs [--level <level>] [--category <name>]"
+                          << " [--since <time>] [--until <time>]" << std::endl;
+                return false;
+            }
+        }
+
+        std::string base = Logger::getInstance().binaryBasePath();
+        if (base.empty()) {
+            base = "/var/log/agi/agi";
+        }
+
+        BinaryLogReader reader(base);
+        size_t matched = 0;
+        reader.scan([&](const BinaryLogRecord& record) {
+            if (record.level < min_level) return;
+            if (record.timestamp_ms < since_ms ||
+                record.timestamp_ms > until_ms) return;
+            if (!category.empty() && record.category != category) return;
+
+            LogEntry entry;
+            entry.level = record.level;
+            std::cout << '[' << formatLogTime(record.timestamp_ms) << "] ["
+                      << entry.levelToString() << "] [" << record.category
+                      << "] " << record.message << '\n';
+            ++matched;
+        });
+        std::cout.flush();
+
+        if (matched == 0) {
+            std::cerr << "No matching log records" << std::endl;
+        }
+        return true;
+    }
+
+    static bool parseLogLevel(const std::string& name, LogLevel& level) {
+        std::string upper = StringUtils::toUpper(name);
+        if (upper == "DEBUG")    { level = LogLevel::DEBUG; return true; }
+        if (upper == "INFO")     { level = LogLevel::INFO; return true; }
+        if (upper == "WARNING" || upper == "WARN") {
+            level = LogLevel::WARNING; return true;
+        }
+        if (upper == "ERROR")    { level = LogLevel::ERROR; return true; }
+        if (upper == "CRITICAL") { level = LogLevel::CRITICAL; return true; }
+        return false;
+    }
+
+    // Accepts epoch seconds or "YYYY-MM-DD HH:MM:SS" (local time)
+    static bool parseLogTime(const std::string& text, int64_t& out_ms) {
+        if (!text.empty() &&
+            text.find_first_not_of("0123456789") == std::string::npos) {
+            out_ms = std::stoll(text) * 1000;
+            return true;
+        }
+
+        struct tm tm {};
+        const char* end = strptime(text.c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+        if (!end) {
+            end = strptime(text.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+        }
+        if (!end) {
+            return false;
+        }
+        tm.tm_isdst = -1;
+        out_ms = static_cast<int64_t>(mktime(&tm)) * 1000;
+        return true;
+    }
+
+    static std::string formatLogTime(int64_t ms) {
+        time_t secs = static_cast<time_t>(ms / 1000);
+        char buf[32];
+        strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", std::localtime(&secs));
+        char out[40];
+        snprintf(out, sizeof(out), "%s.%03d", buf, static_cast<int>(ms % 1000));
+        return out;
+    }
+
+    bool cmdStats(const std::vector<std::string>& args) {
+        bool raw = false;
+        for (const auto& arg : args) {
+            if (arg == "--raw") {
+                raw = true;
+            } else if (arg == "--reset") {
+                PerfRegistry::reset();
+                std::cout << "Timing statistics reset" << std::endl;
+                return true;
+            } else {
+                std::cerr << "Usage: agi stats [--raw] [--reset]" << std::endl;
+                return false;
+            }
+        }
+
+        auto histograms = PerfRegistry::load();
+        if (histograms.empty()) {
+            std::cout << "No timing samples recorded yet" << std::endl;
+            return true;
+        }
+
+        if (raw) {
+            // Machine-readable: one phase per line, nanoseconds
+            std::cout << "phase count sum_ns min_ns max_ns p50_ns p90_ns p99_ns\n";
+            for (const auto& [name, h] : histograms) {
+                std::cout << name << ' ' << h.count << ' ' << h.sum_ns << ' '
+                          << h.min_ns << ' ' << h.max_ns << ' '
+                          << h.percentile(0.50) << ' ' << h.percentile(0.90)
+                          << ' ' << h.percentile(0.99) << '\n';
+            }
+            std::cout.flush();
+            return true;
+        }
+
+        std::cout << "Phase timings (ms):" << std::endl;
+        printf("%-28s %10s %10s %10s %10s %10s %10s\n",
+               "PHASE", "COUNT", "AVG", "MIN", "MAX", "P50", "P99");
+        for (const auto& [name, h] : histograms) {
+            double avg = h.count ? h.sum_ns / 1e6 / h.count : 0.0;
+            printf("%-28s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                   name.c_str(),
+                   static_cast<unsigned long long>(h.count), avg,
+                   h.min_ns / 1e6, h.max_ns / 1e6,
+                   h.percentile(0.50) / 1e6, h.percentile(0.99) / 1e6);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Re-read the configuration and apply only the delta
+     *
+     * Unchanged environments keep their jails untouched; a one-line
+     * edit in a large config costs one jail's worth of churn, not a
+     * pool rebuild.
+     */
+    bool cmdReload() {
+        ReloadDelta delta;
+
+        // The displaced config must outlive applyReload(): every jail
+        // still points into its environments vector until rebound
+        GlobalConfig previous;
+        if (!config_manager_.reload(delta, previous)) {
+            std::cerr << "Configuration error: " << config_manager_.getError() << std::endl;
+            return false;
+        }
+
+        if (!config_manager_.validate()) {
+            std::cerr << "Configuration validation failed: "
+                      << config_manager_.getError() << std::endl;
+            // Reinstate the old config; the jails were never rebound
+            config_manager_.restoreConfig(std::move(previous));
+            return false;
+        }
+
+        jail_pool_.applyReload(config_manager_.getConfig(), delta);
+        // Only now is it safe to drop the old environments vector
+
+        std::cout << "Configuration reloaded: "
+                  << delta.added.size() << " added, "
+                  << delta.removed.size() << " removed, "
+                  << delta.changed.size() << " changed" << std::endl;
+        for (const auto& name : delta.added) {
+            std::cout << "  + " << name << std::endl;
+        }
+        for (const auto& name : delta.removed) {
+            std::cout << "  - " << name << std::endl;
+        }
+        for (const auto& name : delta.changed) {
+            std::cout << "  ~ " << name << " (takes effect on next start)" << std::endl;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Dump per-jail resource usage sampled from /proc
+     *
+     * With a name argument the jail's recent ring is printed as well.
+     * Against a running daemon the rings hold the background sampler's
+     * history; standalone, the two samples taken here still give a
+     * current CPU rate.
+     */
+    bool cmdMetrics(const std::vector<std::string>& args) {
+        std::string filter = args.empty() ? "" : args[0];
+
+        // Two samples a quarter second apart make the CPU rate
+        // computable even when no daemon sampler filled the rings
+        jail_pool_.sampleAllMetrics();
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        jail_pool_.sampleAllMetrics();
+
+        long hz = sysconf(_SC_CLK_TCK);
+        if (hz <= 0) {
+            hz = 100;
+        }
+
+        printf("%-20s %8s %7s %9s %9s %6s %8s\n",
+               "NAME", "PID", "CPU%", "CPU_SEC", "RSS_MB", "FDS", "SAMPLES");
+
+        bool found = false;
+        std::vector<JailMetricsSample> samples;
+        jail_pool_.forEachJail([&](const std::string& name,
+                                   JailManager& jail) {
+            if (!filter.empty() && name != filter) {
+                return;
+            }
+            found = true;
+
+            if (jail.recentMetrics(samples) == 0) {
+                printf("%-20s %8s %7s %9s %9s %6s %8zu\n", name.c_str(),
+                       "-", "-", "-", "-", "-", static_cast<size_t>(0));
+                return;
+            }
+
+            const JailMetricsSample& last = samples.back();
+            double cpu_pct = 0.0;
+            if (samples.size() >= 2) {
+                const JailMetricsSample& prev = samples[samples.size() - 2];
+                double dt = static_cast<double>(last.timestamp -
+                                                prev.timestamp) / 1000.0;
+                if (dt > 0) {
+                    cpu_pct = 100.0 *
+                        (static_cast<double>(last.cpu_ticks -
+                                             prev.cpu_ticks) / hz) / dt;
+                }
+            }
+
+            JailRuntimeInfo info = jail.getRuntimeInfo();
+            printf("%-20s %8d %7.1f %9.2f %9.1f %6d %8zu\n", name.c_str(),
+                   info.pid, cpu_pct,
+                   static_cast<double>(last.cpu_ticks) / hz,
+                   static_cast<double>(last.rss_kb) / 1024.0,
+                   last.fd_count, samples.size());
+
+            // Named jail: also dump the ring, oldest first
+            if (!filter.empty()) {
+                printf("\n%-24s %9s %9s %6s\n",
+                       "TIME", "CPU_SEC", "RSS_MB", "FDS");
+                for (const auto& s : samples) {
+                    time_t secs = static_cast<time_t>(s.timestamp / 1000);
+                    struct tm tm_buf;
+                    char when[32] = "-";
+                    if (localtime_r(&secs, &tm_buf)) {
+                        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S",
+                                 &tm_buf);
+                    }
+                    printf("%-24s %9.2f %9.1f %6d\n", when,
+                           static_cast<double>(s.cpu_ticks) / hz,
+                           static_cast<double>(s.rss_kb) / 1024.0,
+                           s.fd_count);
+                }
+            }
+        });
+
+        if (!filter.empty() && !found) {
+            std::cerr << "Error: Environment '" << filter << "' not found"
+                      << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     bool cmdValidate() {
         if (!config_manager_.load()) {
             std::cerr << "Configuration error: " << config_manager_.getError() << std::endl;
@@ -618,6 +1270,23 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Collect command arguments for daemon forwarding
+    std::vector<std::string> forward_args;
+    for (int i = 2; i < argc; ++i) {
+        forward_args.push_back(argv[i]);
+    }
+
+    // Forward to a running daemon when possible: the daemon already holds
+    // the parsed config and jail pool, so the client skips the cold start.
+    // Interactive and local-only commands are always handled in-process.
+    if (command != "daemon" && command != "init" &&
+        command != "validate" && command != "ssh" && command != "apply") {
+        int exit_code = 0;
+        if (agi::DaemonClient::trySend(command, forward_args, exit_code)) {
+            return exit_code;
+        }
+    }
+
     // Create CLI handler and run
     agi::CliHandler handler(argc, argv);
     int result = handler.run();
@@ -0,0 +1,187 @@
+/**
+ * @file ports.hpp
+ * @brief SSH port registry with bitmap-backed allocation
+ * @author AGI Team
+ * @version 1.0.0
+ * @date 2025-12-28
+ */
+
+#ifndef AGI_PORTS_HPP
+#define AGI_PORTS_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "utils.hpp"
+
+namespace agi {
+
+/**
+ * @brief Bitmap allocator over a contiguous SSH port range
+ *
+ * One bit per port in the configured range; a set bit means the port is
+ * taken. Allocation scans whole 64-bit words and resolves the first
+ * free bit with a count-trailing-zeros, so finding a port is O(range/64)
+ * in the worst case and O(1) when the range is not nearly full.
+ *
+ * The registry is rebuilt from the loaded config on every run and
+ * merged with a small snapshot persisted next to the config file, so a
+ * port handed out by `agi create` stays reserved even if the config
+ * save that should record it fails.
+ */
+class PortRegistry {
+private:
+    static constexpr uint32_t MAGIC = 0x50494741;  // "AGIP"
+    static constexpr uint32_t VERSION = 1;
+
+    int first_ = 0;
+    int last_ = -1;
+    std::vector<uint64_t> words_;
+
+public:
+    PortRegistry(int first, int last) {
+        if (first < 1) first = 1;
+        if (last > 65535) last = 65535;
+        first_ = first;
+        last_ = last;
+        size_t bits = last >= first ? static_cast<size_t>(last - first + 1) : 0;
+        words_.assign((bits + 63) / 64, 0);
+    }
+
+    int firstPort() const { return first_; }
+    int lastPort() const { return last_; }
+
+    bool contains(int port) const {
+        return port >= first_ && port <= last_;
+    }
+
+    bool inUse(int port) const {
+        if (!contains(port)) {
+            return false;
+        }
+        size_t bit = static_cast<size_t>(port - first_);
+        return (words_[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    /**
+     * @brief Mark a port as taken
+     * @return Whether the port was in range and previously free
+     */
+    bool reserve(int port) {
+        if (!contains(port)) {
+            return false;
+        }
+        size_t bit = static_cast<size_t>(port - first_);
+        uint64_t mask = 1ULL << (bit % 64);
+        if (words_[bit / 64] & mask) {
+            return false;
+        }
+        words_[bit / 64] |= mask;
+        return true;
+    }
+
+    void release(int port) {
+        if (!contains(port)) {
+            return;
+        }
+        size_t bit = static_cast<size_t>(port - first_);
+        words_[bit / 64] &= ~(1ULL << (bit % 64));
+    }
+
+    /**
+     * @brief Allocate the lowest free port in the range
+     * @return The reserved port, or -1 if the range is exhausted
+     */
+    int allocate() {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t free_bits = ~words_[w];
+            if (free_bits == 0) {
+                continue;
+            }
+            int bit = __builtin_ctzll(free_bits);
+            int port = first_ + static_cast<int>(w * 64) + bit;
+            if (port > last_) {
+                break;  // trailing bits past the range end
+            }
+            words_[w] |= 1ULL << bit;
+            return port;
+        }
+        return -1;
+    }
+
+    size_t usedCount() const {
+        size_t used = 0;
+        for (uint64_t w : words_) {
+            used += static_cast<size_t>(__builtin_popcountll(w));
+        }
+        return used;
+    }
+
+    /**
+     * @brief Snapshot path for a given config file
+     */
+    static std::string registryPath(const std::string& config_path) {
+        return config_path + ".ports";
+    }
+
+    /**
+     * @brief Merge a persisted snapshot into this registry (best effort)
+     *
+     * A snapshot for a different range is ignored rather than
+     * translated; the config is the source of truth for the range.
+     */
+    bool load(const std::string& path) {
+        std::string data = FileUtils::read(path);
+        size_t header = sizeof(uint32_t) * 2 + sizeof(int32_t) * 2;
+        if (data.size() < header) {
+            return false;
+        }
+
+        uint32_t magic, version;
+        int32_t first, last;
+        std::memcpy(&magic, data.data(), sizeof(magic));
+        std::memcpy(&version, data.data() + 4, sizeof(version));
+        std::memcpy(&first, data.data() + 8, sizeof(first));
+        std::memcpy(&last, data.data() + 12, sizeof(last));
+
+        if (magic != MAGIC || version != VERSION ||
+            first != first_ || last != last_ ||
+            data.size() < header + words_.size() * sizeof(uint64_t)) {
+            return false;
+        }
+
+        for (size_t w = 0; w < words_.size(); ++w) {
+            uint64_t word;
+            std::memcpy(&word, data.data() + header + w * sizeof(word),
+                        sizeof(word));
+            words_[w] |= word;
+        }
+        return true;
+    }
+
+    bool store(const std::string& path) const {
+        std::string buffer;
+        buffer.reserve(16 + words_.size() * sizeof(uint64_t));
+
+        auto append = [&buffer](const void* p, size_t len) {
+            buffer.append(static_cast<const char*>(p), len);
+        };
+        uint32_t magic = MAGIC, version = VERSION;
+        int32_t first = first_, last = last_;
+        append(&magic, sizeof(magic));
+        append(&version, sizeof(version));
+        append(&first, sizeof(first));
+        append(&last, sizeof(last));
+        for (uint64_t w : words_) {
+            append(&w, sizeof(w));
+        }
+
+        return FileUtils::write(path, buffer);
+    }
+};
+
+} // namespace agi
+
+#endif // AGI_PORTS_HPP
@@ -0,0 +1,340 @@
+/**
+ * @file stats.hpp
+ * @brief Scoped-timer instrumentation with per-phase histograms
+ * @author AGI Team
+ * @version 1.0.0
+ * @date 2025-12-28
+ */
+
+#ifndef AGI_STATS_HPP
+#define AGI_STATS_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "utils.hpp"
+
+namespace agi {
+
+/**
+ * @brief Log2-bucketed latency histogram (nanoseconds)
+ */
+struct PerfHistogram {
+    static constexpr size_t BUCKETS = 64;
+
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    uint64_t buckets[BUCKETS] = {};
+
+    void record(uint64_t ns) {
+        ++count;
+        sum_ns += ns;
+        if (ns < min_ns) min_ns = ns;
+        if (ns > max_ns) max_ns = ns;
+        ++buckets[bucketOf(ns)];
+    }
+
+    void merge(const PerfHistogram& other) {
+        count += other.count;
+        sum_ns += other.sum_ns;
+        if (other.min_ns < min_ns) min_ns = other.min_ns;
+        if (other.max_ns > max_ns) max_ns = other.max_ns;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+    }
+
+    /**
+     * @brief Approximate percentile from the bucket boundaries
+     */
+    uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(p * count);
+        if (rank >= count) rank = count - 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return i == 0 ? 1 : (1ULL << i);
+            }
+        }
+        return max_ns;
+    }
+
+    static size_t bucketOf(uint64_t ns) {
+        size_t b = 0;
+        while (ns > 1 && b < BUCKETS - 1) {
+            ns >>= 1;
+            ++b;
+        }
+        return b;
+    }
+};
+
+/**
+ * @brief Process-wide registry of per-phase timing histograms
+ *
+ * Call sites register a phase name once and record samples through
+ * thread-local buffers, so the hot path is an id lookup plus a vector
+ * push; the shared mutex is only touched on buffer flush. Samples are
+ * merged into /var/lib/agi/stats.bin at process exit so the short-lived
+ * CLI accumulates across invocations and `agi stats` can read them back.
+ */
+class PerfRegistry {
+public:
+    static constexpr uint32_t MAGIC = 0x53494741;  // "AGIS"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char* STATS_PATH = "/var/lib/agi/stats.bin";
+
+private:
+    struct Sample {
+        uint16_t phase;
+        uint64_t ns;
+    };
+
+    struct ThreadBuffer {
+        std::vector<Sample> samples;
+
+        ThreadBuffer() { samples.reserve(FLUSH_WATERMARK); }
+        ~ThreadBuffer();  // flushes remaining samples
+    };
+
+    static constexpr size_t FLUSH_WATERMARK = 256;
+
+    std::mutex mutex_;
+    std::vector<std::string> phase_names_;
+    std::vector<PerfHistogram> histograms_;
+    std::atomic<bool> enabled_;
+
+    PerfRegistry() {
+        const char* env = std::getenv("AGI_PERF");
+        enabled_ = !(env && std::string(env) == "0");
+    }
+
+public:
+    ~PerfRegistry() {
+        persist();
+    }
+
+    static PerfRegistry& getInstance() {
+        static PerfRegistry instance;
+        return instance;
+    }
+
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void setEnabled(bool on) {
+        enabled_ = on;
+    }
+
+    /**
+     * @brief Register a phase name, returning its stable id
+     */
+    uint16_t registerPhase(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < phase_names_.size(); ++i) {
+            if (phase_names_[i] == name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        phase_names_.push_back(name);
+        histograms_.emplace_back();
+        return static_cast<uint16_t>(phase_names_.size() - 1);
+    }
+
+    void record(uint16_t phase, uint64_t ns) {
+        ThreadBuffer& buf = threadBuffer();
+        buf.samples.push_back({phase, ns});
+        if (buf.samples.size() >= FLUSH_WATERMARK) {
+            flushBuffer(buf);
+        }
+    }
+
+    void flushBuffer(ThreadBuffer& buf) {
+        if (buf.samples.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Sample& s : buf.samples) {
+            if (s.phase < histograms_.size()) {
+                histograms_[s.phase].record(s.ns);
+            }
+        }
+        buf.samples.clear();
+    }
+
+    /**
+     * @brief Merge this process's samples into the on-disk histogram file
+     */
+    void persist() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        bool any = false;
+        for (const auto& h : histograms_) {
+            if (h.count > 0) { any = true; break; }
+        }
+        if (!any) return;
+
+        std::map<std::string, PerfHistogram> merged = loadFile(STATS_PATH);
+        for (size_t i = 0; i < phase_names_.size(); ++i) {
+            if (histograms_[i].count > 0) {
+                merged[phase_names_[i]].merge(histograms_[i]);
+            }
+        }
+        writeFile(STATS_PATH, merged);
+    }
+
+    /**
+     * @brief Read the accumulated on-disk histograms
+     */
+    static std::map<std::string, PerfHistogram> load() {
+        return loadFile(STATS_PATH);
+    }
+
+    static void reset() {
+        unlink(STATS_PATH);
+    }
+
+private:
+    static ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    static std::map<std::string, PerfHistogram> loadFile(const std::string& path) {
+        std::map<std::string, PerfHistogram> result;
+
+        MappedFile mapped = FileUtils::readMapped(path);
+        if (!mapped.valid() || mapped.size() < 3 * sizeof(uint32_t)) {
+            return result;
+        }
+
+        const char* data = mapped.data();
+        size_t pos = 0;
+        uint32_t magic, version, entries;
+        std::memcpy(&magic, data, 4);
+        std::memcpy(&version, data + 4, 4);
+        std::memcpy(&entries, data + 8, 4);
+        pos = 12;
+        if (magic != MAGIC || version != VERSION) {
+            return result;
+        }
+
+        for (uint32_t e = 0; e < entries; ++e) {
+            if (pos + 4 > mapped.size()) break;
+            uint32_t name_len;
+            std::memcpy(&name_len, data + pos, 4);
+            pos += 4;
+            if (pos + name_len > mapped.size()) break;
+            std::string name(data + pos, name_len);
+            pos += name_len;
+
+            PerfHistogram h;
+            size_t need = sizeof(uint64_t) * (4 + PerfHistogram::BUCKETS);
+            if (pos + need > mapped.size()) break;
+            std::memcpy(&h.count, data + pos, 8);      pos += 8;
+            std::memcpy(&h.sum_ns, data + pos, 8);     pos += 8;
+            std::memcpy(&h.min_ns, data + pos, 8);     pos += 8;
+            std::memcpy(&h.max_ns, data + pos, 8);     pos += 8;
+            std::memcpy(h.buckets, data + pos,
+                        8 * PerfHistogram::BUCKETS);
+            pos += 8 * PerfHistogram::BUCKETS;
+            result[name] = h;
+        }
+        return result;
+    }
+
+    static void writeFile(const std::string& path,
+                          const std::map<std::string, PerfHistogram>& data) {
+        std::string dir = PathUtils::parent(path);
+        if (!dir.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(dir, ec);
+        }
+
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return;
+
+            uint32_t head[3] = {MAGIC, VERSION,
+                                static_cast<uint32_t>(data.size())};
+            file.write(reinterpret_cast<const char*>(head), sizeof(head));
+
+            for (const auto& [name, h] : data) {
+                uint32_t name_len = static_cast<uint32_t>(name.size());
+                file.write(reinterpret_cast<const char*>(&name_len), 4);
+                file.write(name.data(), name_len);
+                file.write(reinterpret_cast<const char*>(&h.count), 8);
+                file.write(reinterpret_cast<const char*>(&h.sum_ns), 8);
+                file.write(reinterpret_cast<const char*>(&h.min_ns), 8);
+                file.write(reinterpret_cast<const char*>(&h.max_ns), 8);
+                file.write(reinterpret_cast<const char*>(h.buckets),
+                           8 * PerfHistogram::BUCKETS);
+            }
+        }
+        rename(tmp.c_str(), path.c_str());
+    }
+};
+
+inline PerfRegistry::ThreadBuffer::~ThreadBuffer() {
+    PerfRegistry::getInstance().flushBuffer(*this);
+}
+
+/**
+ * @brief RAII timer recording one sample for a registered phase
+ *
+ * When the registry is disabled the constructor does a single relaxed
+ * atomic load and nothing else.
+ */
+class ScopedTimer {
+private:
+    uint16_t phase_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit ScopedTimer(uint16_t phase)
+        : phase_(phase), active_(PerfRegistry::getInstance().enabled()) {
+        if (active_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedTimer() {
+        if (!active_) return;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        PerfRegistry::getInstance().record(
+            phase_, static_cast<uint64_t>(ns));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+/**
+ * @brief Time the enclosing scope under the given phase name
+ *
+ * The id is registered once per call site, so the steady-state cost is
+ * a static read plus the timer itself.
+ */
+#define AGI_PERF_SCOPE(name) \
+    static const uint16_t agi_perf_phase_id_ = \
+        agi::PerfRegistry::getInstance().registerPhase(name); \
+    agi::ScopedTimer agi_perf_timer_(agi_perf_phase_id_)
+
+} // namespace agi
+
+#endif // AGI_STATS_HPP
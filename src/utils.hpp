@@ -10,7 +10,9 @@
 #define AGI_UTILS_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <set>
 #include <sstream>
 #include <fstream>
 #include <iostream>
@@ -22,6 +24,19 @@
 #include <functional>
 #include <optional>
 #include <variant>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <csignal>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 namespace agi {
 
@@ -271,6 +286,239 @@ public:
     }
 };
 
+/**
+ * @brief Native child process execution
+ *
+ * Spawns children with fork+execvp over an argv vector, so no /bin/sh
+ * is involved and arguments are never re-parsed by a shell. Output is
+ * captured through pipes with poll(), optionally bounded by a timeout,
+ * and the exit status is reported exactly.
+ */
+class Process {
+public:
+    /**
+     * @brief Result of a completed child process
+     */
+    struct Output {
+        int exit_code = -1;
+        bool timed_out = false;
+        std::string out;
+        std::string err;
+
+        bool success() const { return exit_code == 0 && !timed_out; }
+    };
+
+    /**
+     * @brief Run a command and capture stdout/stderr
+     * @param argv Command and arguments (argv[0] resolved via PATH)
+     * @param timeout_ms Timeout in milliseconds (-1 = no timeout)
+     * @return Captured output and exit status
+     */
+    static Output run(const std::vector<std::string>& argv, int timeout_ms = -1) {
+        Output result;
+        if (argv.empty()) {
+            return result;
+        }
+
+        int out_pipe[2];
+        int err_pipe[2];
+        if (pipe(out_pipe) != 0) {
+            return result;
+        }
+        if (pipe(err_pipe) != 0) {
+            close(out_pipe[0]);
+            close(out_pipe[1]);
+            return result;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(out_pipe[0]); close(out_pipe[1]);
+            close(err_pipe[0]); close(err_pipe[1]);
+            return result;
+        }
+
+        if (pid == 0) {
+            // Child: wire pipes and exec without any shell
+            dup2(out_pipe[1], STDOUT_FILENO);
+            dup2(err_pipe[1], STDERR_FILENO);
+            close(out_pipe[0]); close(out_pipe[1]);
+            close(err_pipe[0]); close(err_pipe[1]);
+            execChild(argv);
+        }
+
+        close(out_pipe[1]);
+        close(err_pipe[1]);
+
+        result.out.reserve(4096);
+        drainPipes(pid, out_pipe[0], err_pipe[0], timeout_ms, result);
+
+        close(out_pipe[0]);
+        close(err_pipe[0]);
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (WIFEXITED(status)) {
+            result.exit_code = WEXITSTATUS(status);
+        } else if (WIFSIGNALED(status)) {
+            result.exit_code = 128 + WTERMSIG(status);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Run a command inheriting the caller's stdio (interactive)
+     * @param argv Command and arguments
+     * @return Exit code, or -1 if the child could not be spawned
+     */
+    static int runInteractive(const std::vector<std::string>& argv) {
+        if (argv.empty()) {
+            return -1;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            return -1;
+        }
+        if (pid == 0) {
+            execChild(argv);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (WIFEXITED(status)) {
+            return WEXITSTATUS(status);
+        }
+        if (WIFSIGNALED(status)) {
+            return 128 + WTERMSIG(status);
+        }
+        return -1;
+    }
+
+private:
+    [[noreturn]] static void execChild(const std::vector<std::string>& argv) {
+        std::vector<char*> args;
+        args.reserve(argv.size() + 1);
+        for (const auto& arg : argv) {
+            args.push_back(const_cast<char*>(arg.c_str()));
+        }
+        args.push_back(nullptr);
+
+        execvp(args[0], args.data());
+        _exit(127);
+    }
+
+    static void drainPipes(pid_t pid, int out_fd, int err_fd,
+                           int timeout_ms, Output& result) {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+
+        struct pollfd fds[2];
+        fds[0] = {out_fd, POLLIN, 0};
+        fds[1] = {err_fd, POLLIN, 0};
+        bool open[2] = {true, true};
+        std::string* buffers[2] = {&result.out, &result.err};
+        char chunk[4096];
+
+        while (open[0] || open[1]) {
+            int wait_ms = -1;
+            if (timeout_ms >= 0) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+                if (remaining <= 0) {
+                    kill(pid, SIGKILL);
+                    result.timed_out = true;
+                    return;
+                }
+                wait_ms = static_cast<int>(remaining);
+            }
+
+            int ready = poll(fds, 2, wait_ms);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            if (ready == 0) {
+                continue;  // deadline handled above
+            }
+
+            for (int i = 0; i < 2; ++i) {
+                if (!open[i] || !(fds[i].revents & (POLLIN | POLLHUP))) {
+                    continue;
+                }
+                ssize_t n = ::read(fds[i].fd, chunk, sizeof(chunk));
+                if (n > 0) {
+                    buffers[i]->append(chunk, static_cast<size_t>(n));
+                } else {
+                    open[i] = false;
+                    fds[i].fd = -1;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Read-only memory-mapped file view
+ *
+ * Move-only owner of an mmap'd region; consumers read through data()
+ * or view() without any userspace copy of the file content.
+ */
+class MappedFile {
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    MappedFile() = default;
+
+    MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        reset();
+    }
+
+    bool valid() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    std::string_view view() const {
+        return std::string_view(data_, size_);
+    }
+
+private:
+    void reset() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+};
+
 /**
  * @brief File utility class
  */
@@ -282,8 +530,8 @@ public:
      * @return Whether exists
      */
     static bool exists(const std::string& path) {
-        std::ifstream file(path);
-        return file.good();
+        // One access() syscall; no stream construction
+        return access(path.c_str(), F_OK) == 0;
     }
     
     /**
@@ -332,28 +580,410 @@ public:
         return file.good();
     }
     
+    /**
+     * @brief Copy a file through the kernel without userspace buffering
+     * @param src Source path
+     * @param dst Destination path
+     * @param mode Destination permission mode
+     * @return Whether successful
+     *
+     * Tries copy_file_range() first (reflink-capable on supporting
+     * filesystems), falls back to sendfile(), and finally to a chunked
+     * read/write loop for filesystems that support neither. The file
+     * content never round-trips through a std::string, so large
+     * binaries copy at page-cache speed with flat memory usage.
+     */
+    static bool copyFile(const std::string& src, const std::string& dst,
+                         mode_t mode = 0644) {
+        int in = open(src.c_str(), O_RDONLY);
+        if (in < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(in, &st) != 0) {
+            close(in);
+            return false;
+        }
+
+        int out = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+        if (out < 0) {
+            close(in);
+            return false;
+        }
+
+        bool ok = copyRange(in, out, static_cast<size_t>(st.st_size));
+
+        close(in);
+        if (close(out) != 0) {
+            ok = false;
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Memory-map a file for read-only access
+     * @param path File path
+     * @return Mapped view; valid() is false on failure
+     *
+     * Read-only consumers (the config loader, copy sources) get the
+     * page cache directly instead of a buffered read into a string.
+     */
+    static MappedFile readMapped(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return MappedFile();
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return MappedFile();
+        }
+
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return MappedFile();
+        }
+
+        return MappedFile(static_cast<const char*>(map),
+                          static_cast<size_t>(st.st_size));
+    }
+
     /**
      * @brief Get file size
      * @param path File path
      * @return File size in bytes, -1 on failure
      */
     static long long size(const std::string& path) {
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
-        if (!file.is_open()) {
+        // One stat() syscall; no open/seek round-trip
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) {
             return -1;
         }
-        return file.tellg();
+        return static_cast<long long>(st.st_size);
     }
     
+    /**
+     * @brief Ask the kernel to fault a file tree into the page cache
+     * @param root Directory (or file) to warm
+     * @return Bytes advised
+     *
+     * Issues POSIX_FADV_WILLNEED plus readahead() for every regular
+     * file under root, so subsequent reads hit the page cache instead
+     * of cold disk. Purely advisory; failures are skipped.
+     */
+    static uint64_t adviseTree(const std::string& root) {
+        namespace fs = std::filesystem;
+
+        uint64_t bytes = 0;
+        std::error_code ec;
+        if (!fs::exists(root, ec) || ec) {
+            return 0;
+        }
+
+        auto advise = [&bytes](const std::string& file) {
+            int fd = ::open(file.c_str(), O_RDONLY | O_NOFOLLOW);
+            if (fd < 0) {
+                return;
+            }
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                st.st_size > 0) {
+                posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+                readahead(fd, 0, static_cast<size_t>(st.st_size));
+                bytes += static_cast<uint64_t>(st.st_size);
+            }
+            ::close(fd);
+        };
+
+        if (!fs::is_directory(fs::symlink_status(root, ec))) {
+            advise(root);
+            return bytes;
+        }
+
+        fs::recursive_directory_iterator it(
+            root, fs::directory_options::skip_permission_denied, ec), end;
+        for (; !ec && it != end; it.increment(ec)) {
+            if (it->is_symlink(ec) || !it->is_regular_file(ec)) {
+                continue;
+            }
+            advise(it->path().string());
+        }
+        return bytes;
+    }
+
     /**
      * @brief Recursively remove directory
      * @param path Directory path
      * @return Whether successful
      */
     static bool removeRecursive(const std::string& path) {
-        // Use system command for recursive removal
-        std::string cmd = "rm -rf \"" + path + "\"";
-        return system(cmd.c_str()) == 0;
+        return removeRecursiveParallel(path);
+    }
+
+    /**
+     * @brief Recursively delete a directory tree with parallel unlinks
+     * @param path Directory (or file) to delete
+     * @param workers Worker thread count (0 = hardware concurrency)
+     * @return Whether the tree is fully removed
+     *
+     * Walks the tree once, fans the file unlinks out to a worker pool,
+     * then removes the now-empty directories deepest-first. For trees
+     * with millions of small files this is bounded by inode update
+     * parallelism instead of one sequential unlink stream.
+     */
+    static bool removeRecursiveParallel(const std::string& path,
+                                        size_t workers = 0) {
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        fs::file_status st = fs::symlink_status(path, ec);
+        if (ec) {
+            return !fs::exists(path);
+        }
+        if (!fs::is_directory(st)) {
+            return fs::remove(path, ec) || !fs::exists(path);
+        }
+
+        // Single walk: files for the workers, directories with their
+        // depth so they can be rmdir'd deepest-first afterwards
+        std::vector<std::string> files;
+        std::vector<std::pair<int, std::string>> dirs;
+        collectTree(path, 0, files, dirs);
+
+        if (workers == 0) {
+            workers = std::thread::hardware_concurrency();
+            if (workers == 0) {
+                workers = 4;
+            }
+        }
+        workers = std::min(workers, std::max<size_t>(files.size(), 1));
+
+        std::atomic<size_t> next{0};
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            pool.emplace_back([&]() {
+                size_t index;
+                while ((index = next.fetch_add(1)) < files.size()) {
+                    unlink(files[index].c_str());
+                }
+            });
+        }
+        for (auto& worker : pool) {
+            worker.join();
+        }
+
+        std::sort(dirs.begin(), dirs.end(),
+                  [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (const auto& [depth, dir] : dirs) {
+            rmdir(dir.c_str());
+        }
+        rmdir(path.c_str());
+
+        return !fs::exists(path);
+    }
+
+private:
+    static void collectTree(const std::string& dir, int depth,
+                            std::vector<std::string>& files,
+                            std::vector<std::pair<int, std::string>>& dirs) {
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+             it.increment(ec)) {
+            const std::string entry = it->path().string();
+            if (it->is_directory(ec) && !it->is_symlink()) {
+                dirs.emplace_back(depth + 1, entry);
+                collectTree(entry, depth + 1, files, dirs);
+            } else {
+                files.push_back(entry);
+            }
+        }
+    }
+
+    static bool copyRange(int in, int out, size_t length) {
+        size_t remaining = length;
+
+        // Fast path: in-kernel copy, may reflink on btrfs/xfs
+        while (remaining > 0) {
+            ssize_t n = copy_file_range(in, nullptr, out, nullptr,
+                                        remaining, 0);
+            if (n > 0) {
+                remaining -= static_cast<size_t>(n);
+                continue;
+            }
+            if (n == 0) {
+                return remaining == 0;
+            }
+            if (errno == EXDEV || errno == EINVAL ||
+                errno == ENOSYS || errno == EOPNOTSUPP) {
+                break;
+            }
+            return false;
+        }
+
+        // Second tier: sendfile still avoids userspace buffers
+        while (remaining > 0) {
+            ssize_t n = sendfile(out, in, nullptr, remaining);
+            if (n > 0) {
+                remaining -= static_cast<size_t>(n);
+                continue;
+            }
+            if (n == 0) {
+                return remaining == 0;
+            }
+            if (errno == EINVAL || errno == ENOSYS) {
+                break;
+            }
+            return false;
+        }
+
+        // Last resort: bounded chunked copy
+        char buffer[65536];
+        while (remaining > 0) {
+            ssize_t n = ::read(in, buffer, std::min(remaining, sizeof(buffer)));
+            if (n <= 0) {
+                return false;
+            }
+            ssize_t written = 0;
+            while (written < n) {
+                ssize_t w = ::write(out, buffer + written,
+                                    static_cast<size_t>(n - written));
+                if (w <= 0) {
+                    return false;
+                }
+                written += w;
+            }
+            remaining -= static_cast<size_t>(n);
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief Batched writer for many small files under one root
+ *
+ * Callers enqueue (relative path, content, mode) tuples and flush once.
+ * The writer holds the root open and resolves every path with mkdirat/
+ * openat relative to that dirfd, so a root that is swapped out from
+ * under us mid-scaffold (the classic chroot TOCTOU) cannot redirect the
+ * writes; O_NOFOLLOW additionally refuses a symlinked final component.
+ * Parent directories are created in one deduplicated pass, each file is
+ * written with a single writev, and durability is one syncfs on the
+ * root instead of per-file metadata syncs.
+ */
+class BatchFileWriter {
+private:
+    struct Entry {
+        std::string path;     // relative to the root
+        std::string content;
+        mode_t mode;
+    };
+
+    int root_fd_ = -1;
+    std::vector<Entry> entries_;
+
+public:
+    explicit BatchFileWriter(const std::string& root) {
+        root_fd_ = ::open(root.c_str(), O_RDONLY | O_DIRECTORY);
+    }
+
+    ~BatchFileWriter() {
+        if (root_fd_ >= 0) {
+            ::close(root_fd_);
+        }
+    }
+
+    BatchFileWriter(const BatchFileWriter&) = delete;
+    BatchFileWriter& operator=(const BatchFileWriter&) = delete;
+
+    bool valid() const { return root_fd_ >= 0; }
+
+    /**
+     * @brief Enqueue one file; leading slashes are stripped
+     */
+    void add(const std::string& path, std::string content, mode_t mode = 0644) {
+        size_t start = path.find_first_not_of('/');
+        if (start == std::string::npos) {
+            return;
+        }
+        entries_.push_back({path.substr(start), std::move(content), mode});
+    }
+
+    size_t pending() const { return entries_.size(); }
+
+    /**
+     * @brief Write everything enqueued since the last flush
+     * @return Number of files written successfully
+     */
+    size_t flush() {
+        if (root_fd_ < 0 || entries_.empty()) {
+            entries_.clear();
+            return 0;
+        }
+
+        // Deduplicated parent-directory pass; the set keeps prefixes
+        // sorted so each chain is created root-first exactly once
+        std::set<std::string> dirs;
+        for (const auto& entry : entries_) {
+            size_t pos = 0;
+            while ((pos = entry.path.find('/', pos)) != std::string::npos) {
+                dirs.insert(entry.path.substr(0, pos));
+                ++pos;
+            }
+        }
+        for (const auto& dir : dirs) {
+            if (mkdirat(root_fd_, dir.c_str(), 0755) != 0 &&
+                errno != EEXIST) {
+                // openat below reports the real failure per file
+                continue;
+            }
+        }
+
+        size_t written = 0;
+        for (const auto& entry : entries_) {
+            int fd = openat(root_fd_, entry.path.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW,
+                            entry.mode);
+            if (fd < 0) {
+                continue;
+            }
+
+            struct iovec iov;
+            iov.iov_base = const_cast<char*>(entry.content.data());
+            iov.iov_len = entry.content.size();
+
+            bool ok = true;
+            size_t off = 0;
+            while (off < entry.content.size()) {
+                iov.iov_base = const_cast<char*>(entry.content.data() + off);
+                iov.iov_len = entry.content.size() - off;
+                ssize_t n = writev(fd, &iov, 1);
+                if (n < 0) {
+                    ok = false;
+                    break;
+                }
+                off += static_cast<size_t>(n);
+            }
+
+            // O_CREAT mode is filtered by the umask; enforce the
+            // requested bits on the open descriptor
+            if (ok && fchmod(fd, entry.mode) == 0) {
+                ++written;
+            }
+            ::close(fd);
+        }
+
+        // One durability point for the whole burst
+        syncfs(root_fd_);
+
+        entries_.clear();
+        return written;
     }
 };
 
@@ -400,46 +1030,32 @@ class CommandUtils {
 public:
     /**
      * @brief Execute command and get output
-     * @param cmd Command
-     * @param captureStderr Whether to capture stderr
+     * @param argv Command and arguments (no shell involved)
+     * @param captureStderr Whether to include stderr in the output
      * @return Command output
      */
-    static std::string exec(const std::string& cmd, bool captureStderr = false) {
-        std::string fullCmd = cmd;
-        if (captureStderr) {
-            fullCmd += " 2>&1";
-        } else {
-            fullCmd += " 2>/dev/null";
-        }
-        
-        FILE* pipe = popen(fullCmd.c_str(), "r");
-        if (!pipe) {
-            throw std::runtime_error("Cannot execute command: " + cmd);
-        }
-        
-        char buffer[4096];
-        std::string result;
-        
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            result += buffer;
+    static std::string exec(const std::vector<std::string>& argv,
+                            bool captureStderr = false) {
+        Process::Output result = Process::run(argv);
+        if (result.exit_code != 0) {
+            throw std::runtime_error("Command execution failed: " +
+                                     (argv.empty() ? "" : argv[0]) +
+                                     " (exit code: " +
+                                     std::to_string(result.exit_code) + ")");
         }
-        
-        int status = pclose(pipe);
-        if (status != 0) {
-            throw std::runtime_error("Command execution failed: " + cmd + " (exit code: " +
-                                    std::to_string(status) + ")");
+        if (captureStderr) {
+            return result.out + result.err;
         }
-        
-        return result;
+        return result.out;
     }
-    
+
     /**
      * @brief Execute command (silent mode)
-     * @param cmd Command
+     * @param argv Command and arguments
      * @return Whether successful
      */
-    static bool execSilent(const std::string& cmd) {
-        return system(cmd.c_str()) == 0;
+    static bool execSilent(const std::vector<std::string>& argv) {
+        return Process::run(argv).success();
     }
 };
 